@@ -22,6 +22,7 @@
 #include "include.h"
 #include "GUIBaseContainer.h"
 #include "GuiControlFactory.h"
+#include "GUIWindowManager.h"
 #include "utils/GUIInfoManager.h"
 #include "XMLUtils.h"
 #include "SkinInfo.h"
@@ -761,6 +762,8 @@ void CGUIBaseContainer::UpdateScrollOffset()
     m_scrollTimer.Stop();
   }
   m_scrollLastTime = m_renderTime;
+  if (m_scrollSpeed)
+    m_gWindowManager.MarkDirty();
 }
 
 int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
@@ -294,6 +294,7 @@ void CGUIButtonScroller::Render()
   // if we're scrolling, update our scroll offset
   if (m_bScrollUp || m_bScrollDown)
   {
+    m_gWindowManager.MarkDirty();
     float maxScroll = m_bHorizontal ? m_imgFocus.GetWidth() : m_imgFocus.GetHeight();
     maxScroll += m_buttonGap;
     m_scrollOffset += (int)(maxScroll / m_fScrollSpeed) + 1;
@@ -358,6 +359,7 @@ void CGUIButtonScroller::Render()
     // check if we're moving up or down
     if (m_bMoveUp || m_bMoveDown)
     {
+      m_gWindowManager.MarkDirty();
       float maxScroll = m_bHorizontal ? m_imgFocus.GetWidth() : m_imgFocus.GetHeight();
       maxScroll += m_buttonGap;
       m_scrollOffset += maxScroll / SCROLL_SPEED + 1;
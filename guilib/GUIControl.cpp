@@ -684,6 +684,9 @@ void CGUIControl::Animate(DWORD currentTime)
     anim.Animate(currentTime, HasRendered() || visible == DELAYED);
     // Update the control states (such as visibility)
     UpdateStates(anim.GetType(), anim.GetProcess(), anim.GetState());
+    // keep drawing frames until the animation has settled
+    if (anim.GetState() == ANIM_STATE_IN_PROCESS || anim.GetState() == ANIM_STATE_DELAYED)
+      m_gWindowManager.MarkDirty();
     // and render the animation effect
     anim.RenderAnimation(m_transform, center);
 
@@ -21,6 +21,7 @@
 
 #include "include.h"
 #include "GUIControlGroupList.h"
+#include "GUIWindowManager.h"
 #include "utils/GUIInfoManager.h"
 
 #define TIME_TO_SCROLL 200;
@@ -54,6 +55,8 @@ void CGUIControlGroupList::Render()
       m_offset = m_scrollOffset;
       m_scrollSpeed = 0;
     }
+    else
+      m_gWindowManager.MarkDirty();
   }
   m_scrollTime = m_renderTime;
 
@@ -21,6 +21,7 @@
 
 #include "include.h"
 #include "GUIFadeLabelControl.h"
+#include "GUIWindowManager.h"
 #include "utils/CharsetConverter.h"
 
 using namespace std;
@@ -109,6 +110,9 @@ void CGUIFadeLabelControl::Render()
     return;
   }
 
+  // from here on we're either scrolling or fading between labels
+  m_gWindowManager.MarkDirty();
+
   bool moveToNextLabel = false;
   if (!m_scrollOut)
   {
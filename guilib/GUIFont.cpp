@@ -22,6 +22,7 @@
 #include "include.h"
 #include "GUIFont.h"
 #include "GraphicContext.h"
+#include "GUIWindowManager.h"
 
 #include "utils/SingleLock.h"
 #include <math.h>
@@ -124,6 +125,9 @@ void CGUIFont::DrawScrollingText(float x, float y, const std::vector<DWORD> &col
   if (!text.size() || ClippedRegionIsEmpty(x, y, maxWidth, alignment))
     return; // nothing to render
 
+  // scrolling (and waiting to scroll) advances per frame, so we need the next one
+  m_gWindowManager.MarkDirty();
+
   maxWidth = ROUND(maxWidth / g_graphicsContext.GetGUIScaleX());
 
   // draw at our scroll position
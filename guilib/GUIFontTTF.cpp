@@ -88,6 +88,7 @@ DWORD PadPow2(DWORD x);
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define CHAR_LINES_PER_PAGE 8 // texture lines dropped together once the texture can't grow any more
 
 int CGUIFontTTF::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -185,8 +186,12 @@ CGUIFontTTF::CGUIFontTTF(const CStdString& strFileName)
   m_char = NULL;
   m_maxChars = 0;
   m_dwNestedBeginCount = 0;
+  m_useCount = 0;
+  m_textureFull = false;
 #ifdef HAS_SDL_OPENGL
   m_glTextureLoaded = false;
+  m_glTextureHeight = 0;
+  m_dirtyTop = m_dirtyBottom = 0;
 #endif
   m_face = NULL;
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -243,11 +248,73 @@ void CGUIFontTTF::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
+  m_pageUsed.clear();
+  m_textureFull = false;
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)m_cellHeight;
 }
 
+bool CGUIFontTTF::EvictPage()
+{
+  // only worth it once the texture is as large as it gets, and there's something left afterwards
+  if (!m_textureFull || m_pageUsed.size() < 2)
+    return false;
+
+  unsigned int victim = 0;
+  for (unsigned int i = 1; i < m_pageUsed.size(); i++)
+  {
+    if (m_pageUsed[i] < m_pageUsed[victim])
+      victim = i;
+  }
+
+  // drop its characters, keeping the rest in order
+  int numChars = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].page != victim)
+      m_char[numChars++] = m_char[i];
+  }
+  CLog::Log(LOGDEBUG, "GUIFontTTF::EvictPage: Dropping %i characters on page %u of the character cache", m_numChars - numChars, victim);
+  m_numChars = numChars;
+  memset(m_charquick, 0, sizeof(m_charquick));
+
+  // and wipe it clean
+  unsigned int pageHeight = m_cellHeight * CHAR_LINES_PER_PAGE;
+  unsigned int top = victim * pageHeight;
+  unsigned int bottom = min(top + pageHeight, m_textureHeight);
+#ifndef HAS_SDL
+  D3DLOCKED_RECT lr;
+  RECT rect = { 0, top, m_textureWidth, bottom };
+  m_texture->LockRect(0, &lr, &rect, 0);
+  for (unsigned int y = 0; y < bottom - top; y++)
+    memset((BYTE *)lr.pBits + y * lr.Pitch, 0, m_textureWidth);
+  m_texture->UnlockRect(0);
+#else
+  SDL_LockSurface(m_texture);
+  memset((unsigned char *)m_texture->pixels + top * m_texture->pitch, 0, (bottom - top) * m_texture->pitch);
+  SDL_UnlockSurface(m_texture);
+#ifdef HAS_SDL_OPENGL
+  if (m_dirtyBottom > m_dirtyTop)
+  {
+    m_dirtyTop = min(m_dirtyTop, (int)top);
+    m_dirtyBottom = max(m_dirtyBottom, (int)bottom);
+  }
+  else
+  {
+    m_dirtyTop = top;
+    m_dirtyBottom = bottom;
+  }
+#endif
+#endif
+
+  // new characters go here until the page is full again
+  m_posX = 0;
+  m_posY = top;
+  m_pageUsed[victim] = m_useCount;
+  return true;
+}
+
 void CGUIFontTTF::Clear()
 {
   if (m_texture)
@@ -334,6 +401,8 @@ bool CGUIFontTTF::Load(const CStdString& strFile, float height, float aspect, fl
 
   m_maxChars = 0;
   m_numChars = 0;
+  m_pageUsed.clear();
+  m_textureFull = false;
 
   m_strFilename = strFilename;
 
@@ -509,7 +578,10 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(DWORD chr)
   {
     DWORD ch = (style << 8) | letter;
     if (m_charquick[ch])
+    {
+      m_pageUsed[m_charquick[ch]->page] = m_useCount;
       return m_charquick[ch];
+    }
   }
 
   // letters are stored based on style and letter
@@ -526,7 +598,10 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(DWORD chr)
     else if (ch < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
+    {
+      m_pageUsed[m_char[mid].page] = m_useCount;
       return &m_char[mid];
+    }
   }
   // if we get to here, then low is where we should insert the new character
 
@@ -554,13 +629,25 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(DWORD chr)
   m_dwNestedBeginCount = 1;
   if (dwNestedBeginCount) End();
   if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
-    ClearCharacterCache();
-    low = 0;
+  { // unable to cache character - make room by dropping the least recently used page,
+    // or if we can't, try clearing them all out and starting over
+    memmove(m_char + low, m_char + low + 1, (m_numChars - low) * sizeof(Character));
+    if (EvictPage())
+    {
+      for (low = 0; low < m_numChars && m_char[low].letterAndStyle < ch; low++)
+        ;
+      memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+    }
+    else
+    {
+      CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
+      ClearCharacterCache();
+      low = 0;
+    }
     if (!CacheCharacter(letter, style, m_char + low))
     {
       CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
+      memmove(m_char + low, m_char + low + 1, (m_numChars - low) * sizeof(Character));
       if (dwNestedBeginCount) Begin();
       m_dwNestedBeginCount = dwNestedBeginCount;
       return NULL;
@@ -624,7 +711,16 @@ bool CGUIFontTTF::CacheCharacter(WCHAR letter, DWORD style, Character *ch)
     if (bitGlyph->left < 0)
       m_posX += -bitGlyph->left;
 
-    if(m_posY + m_cellHeight >= m_textureHeight)
+    if (m_textureFull)
+    { // we're refilling an evicted page, and mustn't run into the next one
+      unsigned int pageHeight = m_cellHeight * CHAR_LINES_PER_PAGE;
+      if (m_posY % pageHeight == 0 || m_posY + m_cellHeight > m_textureHeight)
+      {
+        FT_Done_Glyph(glyph);
+        return false;
+      }
+    }
+    else if(m_posY + m_cellHeight >= m_textureHeight)
     {
       // create the new larger texture
       unsigned newHeight = m_posY + m_cellHeight;
@@ -635,6 +731,7 @@ bool CGUIFontTTF::CacheCharacter(WCHAR letter, DWORD style, Character *ch)
       if (newHeight > 4096)
       {
         CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%i > 4096 pixels long)", newHeight);
+        m_textureFull = true;
         FT_Done_Glyph(glyph);
         return false;
       }
@@ -726,6 +823,10 @@ bool CGUIFontTTF::CacheCharacter(WCHAR letter, DWORD style, Character *ch)
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = ROUND( (float)m_face->glyph->advance.x / 64 );
+  ch->page = (unsigned short)(m_posY / (m_cellHeight * CHAR_LINES_PER_PAGE));
+  if (ch->page >= m_pageUsed.size())
+    m_pageUsed.resize(ch->page + 1, 0);
+  m_pageUsed[ch->page] = m_useCount;
 
   // we need only render if we actually have some pixels
   if (bitmap.width * bitmap.rows)
@@ -761,16 +862,20 @@ bool CGUIFontTTF::CacheCharacter(WCHAR letter, DWORD style, Character *ch)
     }
     // THE SOURCE VALUES ARE THE SAME IN BOTH SITUATIONS.
     
-    // Since we have a new texture, we need to delete the old one
-    // the Begin(); End(); stuff is handled by whoever called us
-    if (m_glTextureLoaded)
+    // Only these rows need uploading again, which Begin() does (the Begin(); End(); stuff is
+    // handled by whoever called us). A texture that grew is uploaded again in full.
+    int top = m_posY + ch->offsetY;
+    int bottom = top + bitmap.rows;
+    if (m_dirtyBottom > m_dirtyTop)
     {
-      g_graphicsContext.BeginPaint();  //FIXME
-      if (glIsTexture(m_glTexture))
-        glDeleteTextures(1, &m_glTexture);
-      g_graphicsContext.EndPaint();
-      m_glTextureLoaded = false;
-    }        
+      m_dirtyTop = min(m_dirtyTop, top);
+      m_dirtyBottom = max(m_dirtyBottom, bottom);
+    }
+    else
+    {
+      m_dirtyTop = top;
+      m_dirtyBottom = bottom;
+    }
 #else
     unsigned int *target = (unsigned int*) (m_texture->pixels) + 
         ((m_posY + ch->offsetY) * m_texture->pitch/4) + 
@@ -803,6 +908,7 @@ void CGUIFontTTF::Begin()
 {
   if (m_dwNestedBeginCount == 0)
   {
+    m_useCount++;
 #ifndef HAS_SDL
     // just have to blit from our texture.
     m_pD3DDevice->SetTexture( 0, m_texture );
@@ -837,8 +943,11 @@ void CGUIFontTTF::Begin()
     m_pD3DDevice->Begin(D3DPT_QUADLIST);
 #endif
 #elif defined(HAS_SDL_OPENGL)
-    if (!m_glTextureLoaded)
+    if (!m_glTextureLoaded || m_glTextureHeight != (unsigned int)m_texture->h)
     {
+      if (m_glTextureLoaded && glIsTexture(m_glTexture))
+        glDeleteTextures(1, &m_glTexture);
+
       // Have OpenGL generate a texture object handle for us
       glGenTextures(1, &m_glTexture);
  
@@ -856,7 +965,17 @@ void CGUIFontTTF::Begin()
     
       VerifyGLState();
       m_glTextureLoaded = true;                
+      m_glTextureHeight = m_texture->h;
+    }
+    else if (m_dirtyBottom > m_dirtyTop)
+    {
+      // just the characters cached since we were last drawn
+      glBindTexture(GL_TEXTURE_2D, m_glTexture);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_dirtyTop, m_texture->w, m_dirtyBottom - m_dirtyTop,
+                      GL_ALPHA, GL_UNSIGNED_BYTE, (unsigned char *)m_texture->pixels + m_dirtyTop * m_texture->pitch);
+      VerifyGLState();
     }
+    m_dirtyTop = m_dirtyBottom = 0;
   
     // Turn Blending On
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -875,7 +994,7 @@ void CGUIFontTTF::Begin()
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     VerifyGLState();
 
-    glBegin(GL_QUADS);
+    m_vertex.clear();
 #endif
   }
   // Keep track of the nested begin/end calls.
@@ -898,7 +1017,17 @@ void CGUIFontTTF::End()
   m_pD3DDevice->SetTexture(0, NULL);
   m_pD3DDevice->SetTextureStageState( 0, D3DTSS_COLOROP, D3DTOP_MODULATE );
 #elif defined(HAS_SDL_OPENGL)
-  glEnd();  
+  if (m_vertex.size())
+  {
+    // one call for the whole block rather than three per vertex
+    glInterleavedArrays(GL_T2F_C4UB_V3F, 0, &m_vertex[0]);
+    glDrawArrays(GL_QUADS, 0, m_vertex.size());
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    VerifyGLState();
+    m_vertex.clear();
+  }
 #endif
 }
 
@@ -1029,27 +1158,21 @@ struct CUSTOMVERTEX {
   float tt = texture.y1 / m_textureHeight;
   float tb = texture.y2 / m_textureHeight;
 
-  GLubyte colors[4] = { (GLubyte)((dwColor >> 16) & 0xff), (GLubyte)((dwColor >> 8) & 0xff), (GLubyte)(dwColor & 0xff), (GLubyte)(dwColor >> 24) };
-
-  // Top-left vertex (corner)
-  glColor4ubv(colors); 
-  glTexCoord2f(tl, tt);
-  glVertex3f(x[0], y1, z1);
-   
-  // Bottom-left vertex (corner)
-  glColor4ubv(colors); 
-  glTexCoord2f(tr, tt);
-  glVertex3f(x[1], y2, z2);
-    
-  // Bottom-right vertex (corner)
-  glColor4ubv(colors); 
-  glTexCoord2f(tr, tb);
-  glVertex3f(x[2], y3, z3);
-    
-  // Top-right vertex (corner)
-  glColor4ubv(colors); 
-  glTexCoord2f(tl, tb);
-  glVertex3f(x[3], y4, z4);
+  SVertex v;
+  v.r = (GLubyte)((dwColor >> 16) & 0xff);
+  v.g = (GLubyte)((dwColor >> 8) & 0xff);
+  v.b = (GLubyte)(dwColor & 0xff);
+  v.a = (GLubyte)(dwColor >> 24);
+
+  // queued up until End()
+  v.u = tl; v.v = tt; v.x = x[0]; v.y = y1; v.z = z1; // Top-left vertex (corner)
+  m_vertex.push_back(v);
+  v.u = tr; v.v = tt; v.x = x[1]; v.y = y2; v.z = z2; // Top-right vertex (corner)
+  m_vertex.push_back(v);
+  v.u = tr; v.v = tb; v.x = x[2]; v.y = y3; v.z = z3; // Bottom-right vertex (corner)
+  m_vertex.push_back(v);
+  v.u = tl; v.v = tb; v.x = x[3]; v.y = y4; v.z = z4; // Bottom-left vertex (corner)
+  m_vertex.push_back(v);
 
 #endif
 }
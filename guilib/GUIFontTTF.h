@@ -63,6 +63,7 @@ class CGUIFontTTF
     float left, top, right, bottom;
     float advance;
     DWORD letterAndStyle;
+    unsigned short page;             // which page of the texture holds it
   };
 public:
 
@@ -107,6 +108,7 @@ protected:
   bool CacheCharacter(WCHAR letter, DWORD style, Character *ch);
   inline void RenderCharacter(float posX, float posY, const Character *ch, D3DCOLOR dwColor, bool roundX);
   void ClearCharacterCache();
+  bool EvictPage();
   
   // modifying glyphs
   void EmboldenGlyph(FT_GlyphSlot slot);
@@ -128,6 +130,10 @@ protected:
   int m_maxChars;                    // size of character array (can be incremented)
   int m_numChars;                    // the current number of cached characters
 
+  std::vector<unsigned int> m_pageUsed; // when each page (band of texture lines) was last drawn from
+  unsigned int m_useCount;           // bumped by every outermost Begin()
+  bool m_textureFull;                // the texture can't grow, so pages are reused instead
+
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
   unsigned int m_cellBaseLine;
@@ -143,6 +149,18 @@ protected:
 #ifdef HAS_SDL_OPENGL
   bool m_glTextureLoaded;
   GLuint m_glTexture;
+  unsigned int m_glTextureHeight;    // height of m_texture when it was last uploaded in full
+  int m_dirtyTop;                    // rows of m_texture changed since the last upload
+  int m_dirtyBottom;
+
+  // matches GL_T2F_C4UB_V3F
+  struct SVertex
+  {
+    float u, v;
+    unsigned char r, g, b, a;
+    float x, y, z;
+  };
+  std::vector<SVertex> m_vertex;     // glyphs of the outermost Begin()/End() block, drawn at once by End()
 #endif
 
   static int justification_word_weight;
@@ -21,6 +21,7 @@
 
 #include "include.h"
 #include "GUIMultiSelectText.h"
+#include "GUIWindowManager.h"
 
 using namespace std;
 
@@ -89,6 +90,8 @@ void CGUIMultiSelectTextControl::Render()
     m_scrollSpeed = 0;
   }
   m_scrollLastTime = m_renderTime;
+  if (m_scrollSpeed)
+    m_gWindowManager.MarkDirty();
 
   // clip and set our scrolling origin
   bool clip(m_width < m_totalWidth);
@@ -24,6 +24,7 @@
 #include "utils/CharsetConverter.h"
 #include "StringUtils.h"
 #include "GUILabelControl.h"
+#include "GUIWindowManager.h"
 #include "utils/GUIInfoManager.h"
 
 using namespace std;
@@ -155,6 +156,8 @@ void CGUITextBox::Render()
     m_scrollSpeed = 0;
   }
   m_lastRenderTime = m_renderTime;
+  if (m_scrollSpeed)
+    m_gWindowManager.MarkDirty();
 
   int offset = (int)(m_scrollOffset / m_itemHeight);
 
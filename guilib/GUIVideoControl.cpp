@@ -50,7 +50,11 @@ void CGUIVideoControl::Render()
   {
 #endif
     if (!g_application.m_pPlayer->IsPaused())
+    {
       g_application.ResetScreenSaver();
+      // there'll be a new video frame to show next time round
+      m_gWindowManager.MarkDirty();
+    }
 
     g_graphicsContext.SetViewWindow(m_posX, m_posY, m_posX + m_width, m_posY + m_height);
 
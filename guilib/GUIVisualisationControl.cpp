@@ -1,6 +1,7 @@
 #include "include.h"
 #include "GUIVisualisationControl.h"
 #include "GUIUserMessages.h"
+#include "GUIWindowManager.h"
 #include "Application.h"
 #include "MusicInfoTag.h"
 #include "visualizations/Visualisation.h"
@@ -226,6 +227,10 @@ void CGUIVisualisationControl::UpdateVisibility(const CGUIListItem *item)
 
 void CGUIVisualisationControl::Render()
 {
+  // visualisations draw something new every frame
+  if (g_application.IsPlayingAudio())
+    m_gWindowManager.MarkDirty();
+
   if (m_pVisualisation == NULL)
   { // check if we need to load
     if (g_application.IsPlayingAudio())
@@ -1137,6 +1137,8 @@ bool CGUIWindow::RenderAnimation(DWORD time)
     CAnimation &anim = m_animations[i];
     anim.Animate(time, true);
     UpdateStates(anim.GetType(), anim.GetProcess(), anim.GetState());
+    if (anim.GetState() == ANIM_STATE_IN_PROCESS || anim.GetState() == ANIM_STATE_DELAYED)
+      m_gWindowManager.MarkDirty();
     anim.RenderAnimation(m_transform, center);
   }
   g_graphicsContext.SetWindowTransform(m_transform);
@@ -39,6 +39,7 @@ CGUIWindowManager::CGUIWindowManager(void)
 
   m_pCallback = NULL;
   m_bShowOverlay = true;
+  m_dirty = true;
 }
 
 CGUIWindowManager::~CGUIWindowManager(void)
@@ -55,6 +56,7 @@ void CGUIWindowManager::Initialize()
 bool CGUIWindowManager::SendMessage(CGUIMessage& message)
 {
   bool handled = false;
+  MarkDirty();
 //  CLog::Log(LOGDEBUG,"SendMessage: mess=%d send=%d control=%d param1=%d", message.GetMessage(), message.GetSenderId(), message.GetControlId(), message.GetParam1());
   // Send the message to all none window targets
   for (int i = 0; i < (int) m_vecMsgTargets.size(); i++)
@@ -138,6 +140,7 @@ bool CGUIWindowManager::SendMessage(CGUIMessage& message)
 
 bool CGUIWindowManager::SendMessage(CGUIMessage& message, DWORD dwWindow)
 {
+  MarkDirty();
   CGUIWindow* pWindow = GetWindow(dwWindow);
   if(pWindow)
     return pWindow->OnMessage(message);
@@ -189,6 +192,7 @@ void CGUIWindowManager::AddModeless(CGUIWindow* dialog)
   for (iDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
     if (*it == dialog) return;
   m_activeDialogs.push_back(dialog);
+  MarkDirty();
 }
 
 void CGUIWindowManager::Remove(DWORD dwID)
@@ -220,6 +224,7 @@ void CGUIWindowManager::Delete(DWORD dwID)
 
 void CGUIWindowManager::PreviousWindow()
 {
+  MarkDirty();
   // deactivate any window
   CLog::Log(LOGDEBUG,"CGUIWindowManager::PreviousWindow: Deactivate");
   DWORD currentWindow = GetActiveWindow();
@@ -323,6 +328,7 @@ void CGUIWindowManager::ActivateWindow(int iWindowID, const CStdString& strPath,
 
 void CGUIWindowManager::ActivateWindow_Internal(int iWindowID, const CStdString& strPath, bool swappingWindows)
 {
+  MarkDirty();
   CStdString strPath1 = strPath;
   // translate virtual windows
   // virtual music window which returns the last open music window (aka the music start window)
@@ -431,6 +437,7 @@ void CGUIWindowManager::CloseDialogs(bool forceClose)
 
 bool CGUIWindowManager::OnAction(const CAction &action)
 {
+  MarkDirty();
   for (rDialog it = m_activeDialogs.rbegin(); it != m_activeDialogs.rend(); ++it)
   {
     CGUIWindow *dialog = *it;
@@ -597,6 +604,7 @@ void CGUIWindowManager::RouteToWindow(CGUIWindow* dialog)
   RemoveDialog(dialog->GetID());
 
   m_activeDialogs.push_back(dialog);
+  MarkDirty();
 }
 
 /// \brief Unroute window
@@ -608,6 +616,7 @@ void CGUIWindowManager::RemoveDialog(DWORD dwID)
     if ((*it)->GetID() == dwID)
     {
       m_activeDialogs.erase(it);
+      MarkDirty();
       return;
     }
   }
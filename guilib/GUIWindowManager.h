@@ -99,6 +99,18 @@ public:
   bool IsOverlayAllowed() const;
   void ShowOverlay(CGUIWindow::OVERLAY_STATE state);
   void GetActiveModelessWindows(std::vector<DWORD> &ids);
+
+  /*! \brief Flag that something on screen changed and the next frame needs to be drawn.
+   May be called from any thread. Controls call this while they animate or scroll, and
+   the window manager calls it for every action, message and window change.
+   */
+  void MarkDirty() { m_dirty = true; };
+  /*! \brief Returns true if anything changed since the last call to ResetDirty()
+   */
+  bool IsDirty() const { return m_dirty; };
+  /*! \brief Called before a frame is drawn. Anything still changing will mark us dirty again while rendering.
+   */
+  void ResetDirty() { m_dirty = false; };
 #ifdef _DEBUG
   void DumpTextureUse();
 #endif
@@ -129,6 +141,7 @@ private:
   std::vector <IMsgTargetCallback*> m_vecMsgTargets;
 
   bool m_bShowOverlay;
+  volatile bool m_dirty;
 };
 
 /*!
@@ -360,40 +360,27 @@ CGLTexture* CGUITextureManager::GetTexture(const CStdString& strTextureName, int
 #endif
 {
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  iMapTextures it = m_mapTextures.find(strTextureName);
+  if (it != m_mapTextures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-      return pMap->GetTexture(iItem, iWidth, iHeight, pPal, linearTexture);
-    }
+    //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
+    return it->second->GetTexture(iItem, iWidth, iHeight, pPal, linearTexture);
   }
   return NULL;
 }
 
 int CGUITextureManager::GetLoops(const CStdString& strTextureName, int iPicture) const
 {
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      return pMap->GetLoops(iPicture);
-    }
-  }
+  ciMapTextures it = m_mapTextures.find(strTextureName);
+  if (it != m_mapTextures.end())
+    return it->second->GetLoops(iPicture);
   return 0;
 }
 int CGUITextureManager::GetDelay(const CStdString& strTextureName, int iPicture) const
 {
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      return pMap->GetDelay(iPicture);
-    }
-  }
+  ciMapTextures it = m_mapTextures.find(strTextureName);
+  if (it != m_mapTextures.end())
+    return it->second->GetDelay(iPicture);
   return 100;
 }
 
@@ -447,12 +434,8 @@ void CGUITextureManager::PreLoad(const CStdString& strTextureName)
   if (strTextureName.c_str()[1] == ':' || strTextureName == "-")
     return ;
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-      return ;
-  }
+  if (m_mapTextures.find(strTextureName) != m_mapTextures.end())
+    return ;
 
   for (int bundle = 0; bundle < 2; bundle++)
   {
@@ -503,24 +486,21 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
     return false;
 
   // first check of texture exists...
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  iMapTextures it = m_mapTextures.find(textureName);
+  if (it != m_mapTextures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
+    for (int i = 0; i < 2; i++)
     {
-      for (int i = 0; i < 2; i++)
+      if (m_iNextPreload[i] != m_PreLoadNames[i].end() && (*m_iNextPreload[i] == textureName))
       {
-        if (m_iNextPreload[i] != m_PreLoadNames[i].end() && (*m_iNextPreload[i] == textureName))
-        {
-          ++m_iNextPreload[i];
-          // preload next file
-          if (m_iNextPreload[i] != m_PreLoadNames[i].end())
-            m_TexBundle[i].PreloadFile(*m_iNextPreload[i]);
-        }
+        ++m_iNextPreload[i];
+        // preload next file
+        if (m_iNextPreload[i] != m_PreLoadNames[i].end())
+          m_TexBundle[i].PreloadFile(*m_iNextPreload[i]);
       }
-      if (size) *size = pMap->size();
-      return true;
     }
+    if (size) *size = it->second->size();
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -742,7 +722,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, DWORD dwColorKey,
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
+    m_mapTextures[strTextureName] = pMap;
     return pMap->size();
   } // of if (strPath.Right(4).ToLower()==".gif")
 
@@ -810,7 +790,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, DWORD dwColorKey,
   CTextureMap* pMap = new CTextureMap(strTextureName);
   CTexture* pclsTexture = new CTexture(pTexture, info.Width, info.Height, bundle >= 0, 100, pPal);
   pMap->Add(pclsTexture);
-  m_vecTextures.push_back(pMap);
+  m_mapTextures[strTextureName] = pMap;
 
 #ifdef HAS_SDL_OPENGL
   SDL_FreeSurface(pTexture);
@@ -844,24 +824,19 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName, int iP
   }
 #endif
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iMapTextures i = m_mapTextures.find(strTextureName);
+  if (i != m_mapTextures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
-    {
-      pMap->Release(iPicture);
+    CTextureMap* pMap = i->second;
+    pMap->Release(iPicture);
 
-      if (pMap->IsEmpty() )
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        delete pMap;
-        i = m_vecTextures.erase(i);
-      }
-      return;
+    if (pMap->IsEmpty() )
+    {
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      delete pMap;
+      m_mapTextures.erase(i);
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
@@ -870,15 +845,13 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (iMapTextures i = m_mapTextures.begin(); i != m_mapTextures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_mapTextures.clear();
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
 }
@@ -886,12 +859,13 @@ void CGUITextureManager::Cleanup()
 void CGUITextureManager::Dump() const
 {
   CStdString strLog;
-  strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
+  strLog.Format("total texturemaps size:%i\n", m_mapTextures.size());
   OutputDebugString(strLog.c_str());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  int i = 0;
+  for (ciMapTextures it = m_mapTextures.begin(); it != m_mapTextures.end(); ++it, ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = it->second;
     if (!pMap->IsEmpty())
     {
       strLog.Format("map:%i\n", i);
@@ -905,16 +879,15 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iMapTextures i = m_mapTextures.begin();
+  while (i != m_mapTextures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      m_mapTextures.erase(i++);
     }
     else
     {
@@ -926,9 +899,9 @@ void CGUITextureManager::Flush()
 DWORD CGUITextureManager::GetMemoryUsage() const
 {
   DWORD memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (ciMapTextures it = m_mapTextures.begin(); it != m_mapTextures.end(); ++it)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += it->second->GetMemoryUsage();
   }
   return memUsage;
 }
@@ -29,6 +29,7 @@
 
 #include "TextureBundle.h"
 #include <vector>
+#include <map>
 
 #pragma once
 
@@ -179,8 +180,10 @@ public:
   void RemoveTexturePath(const CStdString &texturePath); ///< Remove a path from the paths to check when loading media
 
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
+  // keyed by name, as every control looks its textures up by name each time it allocates
+  std::map<CStdString, CTextureMap*> m_mapTextures;
+  typedef std::map<CStdString, CTextureMap*>::iterator iMapTextures;
+  typedef std::map<CStdString, CTextureMap*>::const_iterator ciMapTextures;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
   std::list<CStdString> m_PreLoadNames[2];
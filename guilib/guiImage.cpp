@@ -22,6 +22,7 @@
 #include "include.h"
 #include "guiImage.h"
 #include "TextureManager.h"
+#include "GUIWindowManager.h"
 #include "../xbmc/Util.h"
 #if defined(HAS_SDL_OPENGL)
 #include <GL/glew.h>
@@ -255,9 +256,7 @@ void CGUIImage::Render()
       glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
       VerifyGLState();
     }
-    //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-    //glBegin(GL_LINE_LOOP);
-    glBegin(GL_QUADS);
+    m_vertex.clear();
 #endif
     
     float uLeft, uRight, vTop, vBottom;
@@ -332,7 +331,35 @@ void CGUIImage::Render()
 #endif
 
 #ifdef HAS_SDL_OPENGL      
-    glEnd();
+    if (m_vertex.size())
+    {
+      const GLsizei stride = sizeof(SVertex);
+      glVertexPointer(3, GL_FLOAT, stride, &m_vertex[0].x);
+      glColorPointer(4, GL_UNSIGNED_BYTE, stride, &m_vertex[0].r);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_COLOR_ARRAY);
+      glClientActiveTextureARB(GL_TEXTURE0_ARB);
+      glTexCoordPointer(2, GL_FLOAT, stride, &m_vertex[0].u);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      if (m_diffuseTexture)
+      {
+        glClientActiveTextureARB(GL_TEXTURE1_ARB);
+        glTexCoordPointer(2, GL_FLOAT, stride, &m_vertex[0].u2);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      }
+
+      glDrawArrays(GL_QUADS, 0, m_vertex.size());
+
+      if (m_diffuseTexture)
+      {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glClientActiveTextureARB(GL_TEXTURE0_ARB);
+      }
+      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      glDisableClientState(GL_COLOR_ARRAY);
+      glDisableClientState(GL_VERTEX_ARRAY);
+      VerifyGLState();
+    }
     if (m_diffuseTexture)
     {
       glDisable(GL_TEXTURE_2D);
@@ -592,55 +619,61 @@ void CGUIImage::Render(float left, float top, float right, float bottom, float u
     g_graphicsContext.BlitToScreen(cached.surface, NULL, &dst);
   }
 #elif defined(HAS_SDL_OPENGL)
-  // set all the attributes we need to...
-   
-  // Top-left vertex (corner)
-  DWORD color = g_graphicsContext.MergeAlpha(MIX_ALPHA(m_alpha[0],m_diffuseColor));
-  glColor4ub((GLubyte)((color >> 16) & 0xff), (GLubyte)((color >> 8) & 0xff), (GLubyte)(color & 0xff), (GLubyte)(color >> 24));
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuseTexture)
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x1, y1, z1);
-  
-  // Top-right vertex (corner)
-  color = g_graphicsContext.MergeAlpha(MIX_ALPHA(m_alpha[1],m_diffuseColor));  
-  glColor4ub((GLubyte)((color >> 16) & 0xff), (GLubyte)((color >> 8) & 0xff), (GLubyte)(color & 0xff), (GLubyte)(color >> 24));
+  // queued up, Render() draws all the quads of the image at once
+  SVertex v[4];
+  v[0].x = x1; v[0].y = y1; v[0].z = z1;
+  v[0].u = texture.x1; v[0].v = texture.y1;
+  v[0].u2 = diffuse.x1; v[0].v2 = diffuse.y1;
+
+  v[1].x = x2; v[1].y = y2; v[1].z = z2;
   if (textureOrientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
+  {
+    v[1].u = texture.x1; v[1].v = texture.y2;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuseTexture)
   {
-    if (m_image.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    v[1].u = texture.x2; v[1].v = texture.y1;
+  }
+  if (m_image.orientation & 4)
+  {
+    v[1].u2 = diffuse.x1; v[1].v2 = diffuse.y2;
+  }
+  else
+  {
+    v[1].u2 = diffuse.x2; v[1].v2 = diffuse.y1;
   }
-  glVertex3f(x2, y2, z2);
 
-  // Bottom-right vertex (corner)
-  color = g_graphicsContext.MergeAlpha(MIX_ALPHA(m_alpha[2],m_diffuseColor));  
-  glColor4ub((GLubyte)((color >> 16) & 0xff), (GLubyte)((color >> 8) & 0xff), (GLubyte)(color & 0xff), (GLubyte)(color >> 24));
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuseTexture)
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x3, y3, z3);
-  
-  // Bottom-left vertex (corner)
-  color = g_graphicsContext.MergeAlpha(MIX_ALPHA(m_alpha[3],m_diffuseColor));  
-  glColor4ub((GLubyte)((color >> 16) & 0xff), (GLubyte)((color >> 8) & 0xff), (GLubyte)(color & 0xff), (GLubyte)(color >> 24));
+  v[2].x = x3; v[2].y = y3; v[2].z = z3;
+  v[2].u = texture.x2; v[2].v = texture.y2;
+  v[2].u2 = diffuse.x2; v[2].v2 = diffuse.y2;
+
+  v[3].x = x4; v[3].y = y4; v[3].z = z4;
   if (textureOrientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
+  {
+    v[3].u = texture.x2; v[3].v = texture.y1;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuseTexture)
   {
-    if (m_image.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    v[3].u = texture.x1; v[3].v = texture.y2;
+  }
+  if (m_image.orientation & 4)
+  {
+    v[3].u2 = diffuse.x2; v[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    v[3].u2 = diffuse.x1; v[3].v2 = diffuse.y2;
+  }
+
+  for (int i = 0; i < 4; i++)
+  {
+    DWORD color = g_graphicsContext.MergeAlpha(MIX_ALPHA(m_alpha[i],m_diffuseColor));
+    v[i].r = (GLubyte)((color >> 16) & 0xff);
+    v[i].g = (GLubyte)((color >> 8) & 0xff);
+    v[i].b = (GLubyte)(color & 0xff);
+    v[i].a = (GLubyte)(color >> 24);
+    m_vertex.push_back(v[i]);
   }
-  glVertex3f(x4, y4, z4);
 #endif
 }
 
@@ -964,6 +997,10 @@ void CGUIImage::Process()
       m_iCurrentImage++;
     }
   }
+
+  // keep the frames coming until we've played our last loop
+  if (iMaxLoops <= 0 || m_iCurrentLoop + 1 < iMaxLoops || m_iCurrentImage + 1 < (int)m_vecTextures.size())
+    m_gWindowManager.MarkDirty();
 }
 
 int CGUIImage::GetTextureWidth() const
@@ -197,6 +197,15 @@ protected:
   SDL_Palette* m_diffusePalette;
   SDL_Palette* m_pPalette;
   std::vector <CGLTexture*> m_vecTextures;
+
+  struct SVertex
+  {
+    float u, v;       // texture
+    float u2, v2;     // diffuse
+    unsigned char r, g, b, a;
+    float x, y, z;
+  };
+  std::vector <SVertex> m_vertex; // quads of the current Render(), drawn in one call
 #endif  
   float m_diffuseScaleU, m_diffuseScaleV;
   CPoint m_diffuseOffset;
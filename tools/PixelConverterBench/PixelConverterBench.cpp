@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Times CPixelConverter on what a video thumbnail takes: a 1080p YV12 frame converted to
+// RGB32 and scaled down to a thumbnail. The plain C kernels are timed against the SSE2 ones,
+// and with "make swscale" against the single swscale call which used to do it all.
+//
+// Usage: PixelConverterBench [iterations]
+
+#include "stdafx.h"
+#include "PixelConverter.h"
+#include <sys/time.h>
+#include <vector>
+
+#ifdef USE_SWSCALE
+extern "C" {
+#include <libswscale/swscale.h>
+}
+#endif
+
+using namespace std;
+
+CCPUInfo g_cpuInfo;
+
+#define SRC_WIDTH   1920
+#define SRC_HEIGHT  1080
+#define THUMB_WIDTH  320
+#define THUMB_HEIGHT 180
+
+static double Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+struct Frame
+{
+  vector<BYTE> y, u, v;
+  BYTE* planes[3];
+  int   strides[3];
+
+  Frame() : y(SRC_WIDTH * SRC_HEIGHT), u(SRC_WIDTH * SRC_HEIGHT / 4), v(SRC_WIDTH * SRC_HEIGHT / 4)
+  {
+    // gradients with some noise, so nothing is all one value
+    srand(1);
+    for (int row = 0; row < SRC_HEIGHT; row++)
+      for (int x = 0; x < SRC_WIDTH; x++)
+        y[row * SRC_WIDTH + x] = (BYTE)((x + row) / 12 + (rand() & 15));
+    for (int i = 0; i < (int)u.size(); i++)
+    {
+      u[i] = (BYTE)(i * 7 / SRC_WIDTH + (rand() & 31));
+      v[i] = (BYTE)(255 - i * 5 / SRC_WIDTH + (rand() & 31));
+    }
+
+    planes[0] = &y[0]; strides[0] = SRC_WIDTH;
+    planes[1] = &u[0]; strides[1] = SRC_WIDTH / 2;
+    planes[2] = &v[0]; strides[2] = SRC_WIDTH / 2;
+  }
+};
+
+// runs the conversion and the scaling iterations times, returns ms for each of them per frame
+static void TimeConverter(const Frame& frame, unsigned int features, int iterations,
+                          vector<BYTE>& rgb, vector<BYTE>& thumb, double& convertMs, double& scaleMs)
+{
+  g_cpuInfo.m_cpuFeatures = features;
+  convertMs = scaleMs = 0.0;
+
+  for (int i = 0; i < iterations; i++)
+  {
+    double start = Now();
+    CPixelConverter::YV12ToRGB32(frame.planes, frame.strides, SRC_WIDTH, SRC_HEIGHT, &rgb[0], SRC_WIDTH * 4, true);
+    double converted = Now();
+    CPixelConverter::ScaleRGB32(&rgb[0], SRC_WIDTH, SRC_HEIGHT, SRC_WIDTH * 4,
+                                &thumb[0], THUMB_WIDTH, THUMB_HEIGHT, THUMB_WIDTH * 4);
+    double scaled = Now();
+
+    convertMs += converted - start;
+    scaleMs   += scaled - converted;
+  }
+
+  convertMs /= iterations;
+  scaleMs   /= iterations;
+}
+
+int main(int argc, char* argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 50;
+  if (iterations < 1)
+    iterations = 1;
+
+  Frame frame;
+  vector<BYTE> rgbC(SRC_WIDTH * SRC_HEIGHT * 4), thumbC(THUMB_WIDTH * THUMB_HEIGHT * 4);
+  vector<BYTE> rgbSSE2(rgbC.size()), thumbSSE2(thumbC.size());
+
+  printf("%dx%d YV12 -> RGB32, scaled to %dx%d, %d iterations\n\n",
+         SRC_WIDTH, SRC_HEIGHT, THUMB_WIDTH, THUMB_HEIGHT, iterations);
+  printf("%-10s %10s %10s %10s\n", "", "convert", "scale", "total");
+
+  double convertMs, scaleMs;
+  TimeConverter(frame, 0, iterations, rgbC, thumbC, convertMs, scaleMs);
+  printf("%-10s %8.2fms %8.2fms %8.2fms\n", "C", convertMs, scaleMs, convertMs + scaleMs);
+  double totalC = convertMs + scaleMs;
+
+#ifdef __SSE2__
+  TimeConverter(frame, CPU_FEATURE_SSE2, iterations, rgbSSE2, thumbSSE2, convertMs, scaleMs);
+  printf("%-10s %8.2fms %8.2fms %8.2fms  (%.1fx)\n", "SSE2", convertMs, scaleMs, convertMs + scaleMs,
+         totalC / (convertMs + scaleMs));
+
+  // the kernels have to agree to the bit
+  if (rgbC != rgbSSE2 || thumbC != thumbSSE2)
+  {
+    printf("\nThe SSE2 results differ from the C ones!\n");
+    return 1;
+  }
+#else
+  printf("%-10s not built, the compiler doesn't target SSE2\n", "SSE2");
+#endif
+
+#ifdef USE_SWSCALE
+  // the way thumbnails were made before: one context per picture, converting and scaling at once
+  vector<BYTE> thumbSws(THUMB_WIDTH * THUMB_HEIGHT * 4);
+  double start = Now();
+  for (int i = 0; i < iterations; i++)
+  {
+    struct SwsContext* context = sws_getContext(SRC_WIDTH, SRC_HEIGHT, AV_PIX_FMT_YUV420P,
+                                                THUMB_WIDTH, THUMB_HEIGHT, AV_PIX_FMT_BGRA,
+                                                SWS_FAST_BILINEAR, NULL, NULL, NULL);
+    uint8_t* dst[] = { &thumbSws[0], NULL, NULL, NULL };
+    int dstStride[] = { THUMB_WIDTH * 4, 0, 0, 0 };
+    sws_scale(context, frame.planes, frame.strides, 0, SRC_HEIGHT, dst, dstStride);
+    sws_freeContext(context);
+  }
+  double swsMs = (Now() - start) / iterations;
+  printf("%-10s %10s %10s %8.2fms\n", "swscale", "", "", swsMs);
+#endif
+
+  return 0;
+}
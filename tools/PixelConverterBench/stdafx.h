@@ -0,0 +1,53 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Just enough of the tree's headers for xbmc/utils/PixelConverter.cpp to build on its own.
+// CPUInfo.h is stood in for, so the benchmark can switch the CPU's features off.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned char BYTE;
+typedef long long __int64;
+
+#define CPUINFO_H
+
+#define CPU_FEATURE_MMX      (1 << 0)
+#define CPU_FEATURE_MMX2     (1 << 1)
+#define CPU_FEATURE_SSE      (1 << 2)
+#define CPU_FEATURE_SSE2     (1 << 3)
+#define CPU_FEATURE_SSE3     (1 << 4)
+#define CPU_FEATURE_SSSE3    (1 << 5)
+#define CPU_FEATURE_SSE4     (1 << 6)
+
+class CCPUInfo
+{
+public:
+  CCPUInfo() : m_cpuFeatures(0) {}
+  unsigned int GetCPUFeatures() { return m_cpuFeatures; }
+
+  unsigned int m_cpuFeatures;
+};
+
+extern CCPUInfo g_cpuInfo;
@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Times CResampler against Cssrc, fed a stereo tone the way paplayer_linux feeds them: asked
+// for input with GetInputSamples, given it with PutFloatData and emptied a packet at a time
+// with GetData. Every quality of CResampler is run with its C and its SSE2 code.
+//
+// Speed is given in times realtime on one core. Quality is the signal to noise ratio of the
+// output against the best fitting tone, so drift, noise and glitches between chunks all count.
+//
+// Usage: ResamplerBench [seconds]
+
+#include "stdafx.h"
+#include "utils/CPUInfo.h"
+#include "Resampler.h"
+#include "ssrc.h"
+#include <sys/time.h>
+#include <vector>
+
+using namespace std;
+
+CCPUInfo g_cpuInfo;
+
+#define OUTPUT_RATE 48000
+#define CHANNELS    2
+#define PACKET_SIZE 3840  // bytes, what paplayer asks for
+
+static double Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+// resamples seconds of a tone at frequency, returns how long it took
+template<class Resampler>
+static double Run(Resampler &resampler, int rate, double frequency, int seconds, vector<short> &output)
+{
+  __int64 total = (__int64)rate * seconds;
+  __int64 pos = 0;
+  vector<float> input(PACKET_SIZE);
+  unsigned char packet[PACKET_SIZE];
+
+  double start = Now();
+  while (pos < total)
+  {
+    if (resampler.GetData(packet))
+    {
+      output.insert(output.end(), (short *)packet, (short *)(packet + PACKET_SIZE));
+      continue;
+    }
+
+    int amount = resampler.GetInputSamples();
+    if (amount <= 0 || amount > PACKET_SIZE)
+    {
+      printf("GetInputSamples asked for %d samples\n", amount);
+      exit(1);
+    }
+
+    for (int i = 0; i < amount / CHANNELS; i++)
+    {
+      float value = 0.89f * (float)sin(2 * M_PI * frequency * (pos + i) / rate);
+      for (int c = 0; c < CHANNELS; c++)
+        input[i * CHANNELS + c] = value;
+    }
+    resampler.PutFloatData(&input[0], amount);
+    pos += amount / CHANNELS;
+  }
+  return Now() - start;
+}
+
+// fits a tone of the given frequency to the first channel, leaving out half a second at
+// either end, and returns how far below it what's left over is, in dB
+static double SignalToNoise(const vector<short> &output, double frequency)
+{
+  size_t first = OUTPUT_RATE / 2;
+  size_t last = output.size() / CHANNELS - OUTPUT_RATE / 2;
+  if (last <= first)
+    return 0.0;
+
+  double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+  for (size_t i = first; i < last; i++)
+  {
+    double w = 2 * M_PI * frequency * i / OUTPUT_RATE;
+    double s = sin(w), c = cos(w), y = output[i * CHANNELS];
+    ss += s * s; sc += s * c; cc += c * c;
+    ys += y * s; yc += y * c;
+  }
+
+  double det = ss * cc - sc * sc;
+  double a = (ys * cc - yc * sc) / det;
+  double b = (yc * ss - ys * sc) / det;
+
+  double signal = 0, noise = 0;
+  for (size_t i = first; i < last; i++)
+  {
+    double w = 2 * M_PI * frequency * i / OUTPUT_RATE;
+    double fit = a * sin(w) + b * cos(w), y = output[i * CHANNELS];
+    signal += fit * fit;
+    noise += (y - fit) * (y - fit);
+  }
+  return noise > 0 ? 10 * log10(signal / noise) : 999.0;
+}
+
+static void Print(int rate, double frequency, const char *name, int seconds, double time, const vector<short> &output)
+{
+  printf("%6d  %5.0fHz  %-16s %7.1fx  %5.1f dB\n", rate, frequency, name, seconds / time, SignalToNoise(output, frequency));
+}
+
+int main(int argc, char *argv[])
+{
+  int seconds = argc > 1 ? atoi(argv[1]) : 20;
+  if (seconds < 2)
+    seconds = 2;
+
+  const int rates[] = { 22050, 44100, 96000, 192000 };
+  const double frequencies[] = { 1000, 15000 };
+  const char *qualities[] = { "low", "medium", "high" };
+
+  printf("to %d Hz, %d channels, %d seconds each\n\n", OUTPUT_RATE, CHANNELS, seconds);
+  printf("%6s  %7s  %-16s %8s  %8s\n", "rate", "tone", "", "realtime", "snr");
+
+  for (unsigned r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+  {
+    for (unsigned f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); f++)
+    {
+      int rate = rates[r];
+      double frequency = frequencies[f];
+      if (frequency > rate * 0.4)
+        continue;
+
+      vector<short> output;
+      Cssrc ssrc;
+      if (ssrc.InitConverter(rate, 16, CHANNELS, OUTPUT_RATE, 16, PACKET_SIZE))
+      {
+        double time = Run(ssrc, rate, frequency, seconds, output);
+        Print(rate, frequency, "Cssrc", seconds, time, output);
+      }
+      else
+        printf("%6d  %5.0fHz  Cssrc can't do it\n", rate, frequency);
+
+      for (int q = CResampler::QUALITY_LOW; q <= CResampler::QUALITY_HIGH; q++)
+      {
+        for (int sse2 = 0; sse2 < 2; sse2++)
+        {
+#ifndef __SSE2__
+          // without __SSE2__ CResampler only has its C code, whatever the CPU says
+          if (sse2)
+            continue;
+#endif
+          g_cpuInfo.m_cpuFeatures = sse2 ? CPU_FEATURE_SSE2 : 0;
+
+          output.clear();
+          CResampler resampler;
+          resampler.InitConverter(rate, 16, CHANNELS, OUTPUT_RATE, 16, PACKET_SIZE, (CResampler::Quality)q);
+          double time = Run(resampler, rate, frequency, seconds, output);
+
+          char name[32];
+          sprintf(name, "%s %s", qualities[q], sse2 ? "sse2" : "c");
+          Print(rate, frequency, name, seconds, time, output);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
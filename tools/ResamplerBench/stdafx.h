@@ -0,0 +1,47 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Just enough of the tree's headers for xbmc/cores/Resampler.cpp and xbmc/cores/ssrc.cpp to
+// build on their own. utils/CPUInfo.h is stood in for, so the benchmark can switch SSE2 off.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef unsigned char BYTE;
+typedef unsigned long DWORD;
+typedef long long __int64;
+
+#define ZeroMemory(p, size) memset((p), 0, (size))
+
+#define LOGDEBUG   0
+#define LOGINFO    1
+#define LOGWARNING 2
+#define LOGERROR   3
+
+class CLog
+{
+public:
+  static void Log(int level, const char *format, ...) {}
+};
@@ -80,6 +80,7 @@
 #include "utils/SystemInfo.h"
 #include "ApplicationRenderer.h"
 #include "GUILargeTextureManager.h"
+#include "PlexImageCache.h"
 #include "LastFmManager.h"
 #include "SmartPlaylist.h"
 #include "FileSystem/RarManager.h"
@@ -2756,6 +2757,7 @@ void CApplication::NewFrame()
 
   SDL_mutexV(m_frameMutex);
 #endif
+  m_gWindowManager.MarkDirty();
 }
 
 void CApplication::SetQuiet(bool bQuiet)
@@ -2788,6 +2790,17 @@ void CApplication::Render()
 
   MEASURE_FUNCTION;
 
+  // Skip drawing the GUI when nothing reported a change since the last frame. Info labels and
+  // visibility conditions are only evaluated while rendering, so refresh every so often regardless.
+  static unsigned int lastGUIRenderTime = 0;
+  bool renderGUI = true;
+  if (g_advancedSettings.m_iGUIIdleRefresh > 0 && !m_gWindowManager.IsDirty() &&
+      !(g_graphicsContext.IsFullScreenVideo() && IsPlaying() && !IsPaused()) &&
+      timeGetTime() - lastGUIRenderTime < (unsigned int)g_advancedSettings.m_iGUIIdleRefresh)
+  {
+    renderGUI = false;
+  }
+
   {
     // Frame rate limiter.
     unsigned int singleFrameTime = 1000 / (g_graphicsContext.GetFPS() != 0 ? g_graphicsContext.GetFPS() : 75); // Default limit ~77 FPS
@@ -2815,7 +2828,8 @@ void CApplication::Render()
       double graphicsFPS = (double)g_infoManager.GetFPS();
       double screenFPS = (double)g_graphicsContext.GetFPS();
 
-      if (g_videoConfig.GetVSyncMode() != VSYNC_ALWAYS ||
+      // we won't be blocking on vsync if we're not going to draw, so always limit then.
+      if (!renderGUI || g_videoConfig.GetVSyncMode() != VSYNC_ALWAYS ||
           (graphicsFPS > screenFPS + 10) && graphicsFPS > 1000/singleFrameTime)
       {
         if (lastFrameTime + singleFrameTime > currentTime)
@@ -2840,6 +2854,18 @@ void CApplication::Render()
 
     lastFrameTime = timeGetTime();
   }
+
+  if (!renderGUI)
+  {
+    // DoRender() would have done this, and Process() relies on it.
+    g_infoManager.ResetCache();
+    return;
+  }
+
+  // anything still changing marks us dirty again while it's drawn
+  m_gWindowManager.ResetDirty();
+  lastGUIRenderTime = timeGetTime();
+
   g_graphicsContext.Lock();
   RenderNoPresent();
   // Present the backbuffer contents to the display
@@ -4275,7 +4301,7 @@ void CApplication::Stop()
 #endif
     
     // Stop the texture manager.
-    g_largeTextureManager.StopThread();
+    g_largeTextureManager.Stop();
 
     CLog::Log(LOGNOTICE, "Storing total System Uptime");
     g_stSettings.m_iSystemTimeTotalUp = g_stSettings.m_iSystemTimeTotalUp + (int)(timeGetTime() / 60000);
@@ -4297,6 +4323,9 @@ void CApplication::Stop()
       Sleep(50);
     }
     
+    // Nothing is caching images any more, so write out the image cache index.
+    CPlexImageCache::Shutdown();
+    
     m_bStop = true;
     CLog::Log(LOGNOTICE, "stop all");
 
@@ -5044,6 +5073,7 @@ bool CApplication::ResetScreenSaverWindow()
   // if Screen saver is active
   if (m_bScreenSave)
   {
+    m_gWindowManager.MarkDirty();
     int iProfile = g_settings.m_iLastLoadedProfileIndex;
     if (m_iScreenSaveLock == 0)
       if (g_guiSettings.GetBool("screensaver.uselock")                           &&
@@ -5199,6 +5229,7 @@ void CApplication::ActivateScreenSaver(bool forceType /*= false */)
   m_bScreenSave = true;
   m_bInactive = true;
   m_dwShutdownTick = m_dwSaverTick = timeGetTime();  // Save the current time for the shutdown timeout
+  m_gWindowManager.MarkDirty();
 
   // Get Screensaver Mode
   m_screenSaverMode = g_guiSettings.GetString("screensaver.mode");
@@ -5860,6 +5891,9 @@ void CApplication::Process()
   }
 #endif
 
+  // hand over any large images that finished decoding since the last frame
+  g_largeTextureManager.UploadDecodedImages();
+
   // check if we can free unused memory
 #ifndef _LINUX
   g_audioManager.FreeUnused();
@@ -21,6 +21,7 @@
 #include "stdafx.h"
 #include "BackgroundInfoLoader.h"
 #include "FileItem.h"
+#include "PlexDirectory.h"
 
 #ifdef _XBOX
 #define ITEMS_PER_THREAD 10
@@ -30,6 +31,10 @@
 #define MAX_THREAD_COUNT 5
 #endif
 
+// Workers shared by all the loaders, and how long they hang around with nothing to do.
+#define MAX_POOL_THREADS    MAX_THREAD_COUNT
+#define WORKER_IDLE_TIMEOUT 10000
+
 // Static initializers.
 CCriticalSection        CBackgroundRunner::g_lock;
 set<CBackgroundRunner*> CBackgroundRunner::g_activeThreads;
@@ -42,7 +47,8 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads, int pauseBetweenLoads
   m_pVecItems = NULL;
   m_nRequestedThreads = nThreads;
   m_pauseBetweenLoadsInMS = pauseBetweenLoadsInMS;
-  m_workerGroup = 0;
+  m_nThreads = 1;
+  m_focusItem = 0;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -51,7 +57,7 @@ CBackgroundInfoLoader::~CBackgroundInfoLoader()
   {
     m_workerGroup->Stop();
     m_workerGroup->Detach();
-    m_workerGroup = 0;
+    m_workerGroup.reset();
   }
 }
 
@@ -60,23 +66,40 @@ void CBackgroundInfoLoader::SetNumOfWorkers(int nThreads)
   m_nRequestedThreads = nThreads;
 }
 
+void CBackgroundRunner::StopAll()
+{
+  {
+    CSingleLock lock(g_lock);
+    BOOST_FOREACH(CBackgroundRunner* runner, g_activeThreads)
+      runner->Stop();
+  }
+  
+  // Wake up the idle ones so they notice.
+  CBackgroundRunnerPool::Get().Signal();
+}
+
 void CBackgroundRunner::Process()
 {
+  CBackgroundRunnerPool& pool = CBackgroundRunnerPool::Get();
+  
   try
   {
     while (m_bStop == false)
     {
-      CFileItemPtr pItem = m_group.PopItem();
-      if (pItem)
+      CFileItemPtr pItem;
+      CBackgroundRunnerGroupPtr group = pool.GetWork(pItem);
+      if (group)
       {
         // Load the item.
-        try { m_group.LoadItem(pItem); }
+        try { group->LoadItem(pItem); }
         catch (...) { CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->m_strPath.c_str()); }
+        
+        group->ItemDone();
       }
-      else
+      else if (pool.WaitForWork(WORKER_IDLE_TIMEOUT) == false)
       {
-        // We're done!
-        break;
+        // We've been idle long enough, and the pool has already let us go.
+        return;
       }
     }
   }
@@ -86,13 +109,14 @@ void CBackgroundRunner::Process()
   }
 
   // We're done.
-  m_group.WorkerDone(this);
+  pool.WorkerDone();
 }
 
-void CBackgroundInfoLoader::OnLoaderFinished()
+void CBackgroundInfoLoader::OnLoaderFinished(CBackgroundRunnerGroup* group)
 {
   EnterCriticalSection(m_lock);
-  m_workerGroup = 0;
+  if (m_workerGroup.get() == group)
+    m_workerGroup.reset();
   LeaveCriticalSection(m_lock);
   
   OnLoaderFinish();
@@ -107,15 +131,12 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   
   EnterCriticalSection(m_lock);
 
-  for (int nItem=0; nItem < items.Size(); nItem++)
-    m_vecItems.push_back(items[nItem]);
-
   m_pVecItems = &items;
 
-  // Compute how many threads to spawn.
+  // Compute how many threads to use.
   int nThreads = m_nRequestedThreads;
   if (nThreads == -1)
-    nThreads = (m_vecItems.size() / (ITEMS_PER_THREAD+1)) + 1;
+    nThreads = (items.Size() / (ITEMS_PER_THREAD+1)) + 1;
 
   if (nThreads > MAX_THREAD_COUNT)
     nThreads = MAX_THREAD_COUNT;
@@ -123,11 +144,78 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   if (items.IsPlexMediaServer())
     nThreads = 2;
   
-  // Create a worker group.
+  m_nThreads = nThreads;
+  
+  // Create a worker group, skipping placeholders for items of paged listings which haven't been fetched yet.
   m_bStop = false;
-  m_workerGroup = new CBackgroundRunnerGroup(this, items, nThreads, m_pauseBetweenLoadsInMS);
-      
+  m_focusItem = 0;
+  m_workerGroup.reset(new CBackgroundRunnerGroup(this, nThreads, m_pauseBetweenLoadsInMS));
+  bool bHasItems = false;
+  for (int n=0; n<items.Size(); n++)
+  {
+    if (DIRECTORY::CPlexDirectory::IsPlaceholder(items[n]) == false)
+    {
+      m_workerGroup->AddItem(items[n], n);
+      bHasItems = true;
+    }
+  }
+  
+  // Notify of the start.
+  OnLoaderStart();
+  
+  // No worker would ever pick up a group without items, so it's finished already.
+  if (bHasItems == false)
+  {
+    m_workerGroup.reset();
+    LeaveCriticalSection(m_lock);
+    
+    OnLoaderFinish();
+    return;
+  }
+  
+  CBackgroundRunnerGroupPtr group = m_workerGroup;
+  LeaveCriticalSection(m_lock);
+  
+  CBackgroundRunnerPool::Get().AddGroup(group);
+}
+
+void CBackgroundInfoLoader::Enqueue(const map<int, CFileItemPtr>& items)
+{
+  if (items.empty())
+    return;
+  
+  EnterCriticalSection(m_lock);
+  
+  if (m_workerGroup && m_workerGroup->AddItems(items))
+  {
+    LeaveCriticalSection(m_lock);
+    CBackgroundRunnerPool::Get().Signal();
+    return;
+  }
+  
+  // Nothing running any more, start one new group for all of them.
+  m_bStop = false;
+  m_workerGroup.reset(new CBackgroundRunnerGroup(this, m_nThreads, m_pauseBetweenLoadsInMS));
+  m_workerGroup->SetFocusItem(m_focusItem);
+  m_workerGroup->AddItems(items);
+  
+  OnLoaderStart();
+  
+  CBackgroundRunnerGroupPtr group = m_workerGroup;
   LeaveCriticalSection(m_lock);
+  
+  CBackgroundRunnerPool::Get().AddGroup(group);
+}
+
+void CBackgroundInfoLoader::SetFocusItem(int position)
+{
+  CSingleLock lock(m_lock);
+  if (position == m_focusItem)
+    return;
+  
+  m_focusItem = position;
+  if (m_workerGroup)
+    m_workerGroup->SetFocusItem(position);
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -139,7 +227,7 @@ void CBackgroundInfoLoader::StopAsync()
     // Tell it to stop and then forget about it.
     m_workerGroup->Stop();
     m_workerGroup->Detach();
-    m_workerGroup = 0;
+    m_workerGroup.reset();
   }
  
   m_bStop = true;
@@ -156,7 +244,7 @@ void CBackgroundInfoLoader::StopThread()
 bool CBackgroundInfoLoader::IsLoading()
 {
   CSingleLock lock(m_lock);
-  return m_workerGroup != 0 && m_workerGroup->GetNumActiveThreads() > 0;
+  return m_workerGroup && m_workerGroup->IsFinished() == false;
 }
 
 void CBackgroundInfoLoader::SetObserver(IBackgroundLoaderObserver* pObserver)
@@ -169,3 +257,249 @@ void CBackgroundInfoLoader::SetProgressCallback(IProgressCallback* pCallback)
   m_pProgressCallback = pCallback;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+CBackgroundRunnerGroup::CBackgroundRunnerGroup(CBackgroundInfoLoader* loader, int numThreads, int msBetweenLoads)
+  : m_loader(loader)
+  , m_msBetweenLoads(msBetweenLoads)
+  , m_maxThreads(numThreads)
+  , m_nBusy(0)
+  , m_focus(0)
+  , m_stopped(false)
+  , m_finished(false)
+{
+}
+
+void CBackgroundRunnerGroup::Stop()
+{
+  CSingleLock lock(m_lock);
+  m_stopped = true;
+  m_pending.clear();
+  
+  // Anything being loaded right now will still complete.
+  if (m_nBusy == 0)
+    m_finished = true;
+}
+
+void CBackgroundRunnerGroup::Detach()
+{
+  CSingleLock lock(m_lock);
+  m_loader = 0;
+}
+
+bool CBackgroundRunnerGroup::AddItem(const CFileItemPtr& item, int position)
+{
+  CSingleLock lock(m_lock);
+  if (m_stopped || m_finished)
+    return false;
+  
+  m_pending[position] = item;
+  return true;
+}
+
+bool CBackgroundRunnerGroup::AddItems(const map<int, CFileItemPtr>& items)
+{
+  CSingleLock lock(m_lock);
+  if (m_stopped || m_finished)
+    return false;
+  
+  m_pending.insert(items.begin(), items.end());
+  return true;
+}
+
+void CBackgroundRunnerGroup::SetFocusItem(int position)
+{
+  CSingleLock lock(m_lock);
+  m_focus = position;
+}
+
+CFileItemPtr CBackgroundRunnerGroup::PopItem()
+{
+  CFileItemPtr pItem;
+  
+  CSingleLock lock(m_lock);
+  if (m_stopped || m_pending.empty() || m_nBusy >= m_maxThreads)
+    return pItem;
+  
+  // Take the item closest to the focused one, looking ahead first on a tie, so
+  // whatever is on screen gets loaded before the rest of the list.
+  //
+  map<int, CFileItemPtr>::iterator it = m_pending.lower_bound(m_focus);
+  if (it == m_pending.end())
+  {
+    --it;
+  }
+  else if (it != m_pending.begin())
+  {
+    map<int, CFileItemPtr>::iterator before = it;
+    --before;
+    if (m_focus - before->first < it->first - m_focus)
+      it = before;
+  }
+  
+  pItem = it->second;
+  m_pending.erase(it);
+  m_nBusy++;
+  
+  return pItem;
+}
+
+void CBackgroundRunnerGroup::LoadItem(CFileItemPtr& item)
+{
+  EnterCriticalSection(m_lock);
+  if (m_loader && m_stopped == false)
+  {
+    if (m_loader->GetProgressCallback() == 0 || m_loader->GetProgressCallback()->Abort() == false)
+    {
+      CBackgroundInfoLoader* loader = m_loader;
+
+      // Leave the critical section to load the item.
+      LeaveCriticalSection(m_lock);
+      bool ret = loader->LoadItem(item.get());
+      EnterCriticalSection(m_lock);
+      
+      if (ret)
+      {
+        // Notify the observer.
+        NotifyObserver(item);
+        
+        // Pause if it was requested.
+        if (m_msBetweenLoads > 0 && m_stopped == false)
+        {
+          LeaveCriticalSection(m_lock);
+          ::usleep(m_msBetweenLoads*1000);
+          EnterCriticalSection(m_lock);
+        }
+      }
+    }
+  }
+  
+  LeaveCriticalSection(m_lock);
+}
+
+void CBackgroundRunnerGroup::NotifyObserver(CFileItemPtr& item)
+{
+  CSingleLock lock(m_lock);
+  if (m_stopped == false && m_loader && m_loader->GetObserver())
+    m_loader->GetObserver()->OnItemLoaded(item.get());
+}
+
+void CBackgroundRunnerGroup::ItemDone()
+{
+  EnterCriticalSection(m_lock);
+  m_nBusy--;
+  
+  // If we're the last one on, turn the lights off.
+  if (m_nBusy == 0 && m_pending.empty() && m_finished == false)
+  {
+    m_finished = true;
+    
+    // We don't want to hold this lock, because otherwise we'll have taken 
+    // locks in the opposite order.
+    //
+    CBackgroundInfoLoader* loader = m_loader;
+    LeaveCriticalSection(m_lock);
+    
+    if (loader)
+      loader->OnLoaderFinished(this);
+    
+    return;
+  }
+  
+  if (m_stopped && m_nBusy == 0)
+    m_finished = true;
+  
+  LeaveCriticalSection(m_lock);
+}
+
+bool CBackgroundRunnerGroup::IsFinished()
+{
+  CSingleLock lock(m_lock);
+  return m_finished;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+CBackgroundRunnerPool::CBackgroundRunnerPool()
+  : m_workEvent(true)
+  , m_nWorkers(0)
+  , m_nIdle(0)
+{
+}
+
+CBackgroundRunnerPool& CBackgroundRunnerPool::Get()
+{
+  static CBackgroundRunnerPool pool;
+  return pool;
+}
+
+void CBackgroundRunnerPool::AddGroup(const CBackgroundRunnerGroupPtr& group)
+{
+  CSingleLock lock(m_lock);
+  m_groups.push_front(group);
+  m_workEvent.Set();
+  
+  // Start as many workers as the group can use, as long as the pool has room.
+  for (int wanted = group->GetMaxThreads() - m_nIdle; wanted > 0 && m_nWorkers < MAX_POOL_THREADS; wanted--)
+  {
+    m_nWorkers++;
+    new CBackgroundRunner();
+  }
+}
+
+void CBackgroundRunnerPool::Signal()
+{
+  CSingleLock lock(m_lock);
+  m_workEvent.Set();
+}
+
+CBackgroundRunnerGroupPtr CBackgroundRunnerPool::GetWork(CFileItemPtr& item)
+{
+  CSingleLock lock(m_lock);
+  
+  deque<CBackgroundRunnerGroupPtr>::iterator it = m_groups.begin();
+  while (it != m_groups.end())
+  {
+    CBackgroundRunnerGroupPtr group = *it;
+    if (group->IsFinished())
+    {
+      it = m_groups.erase(it);
+      continue;
+    }
+    
+    item = group->PopItem();
+    if (item)
+      return group;
+    
+    ++it;
+  }
+  
+  // Nothing to do, so sleep until more work comes in.
+  m_workEvent.Reset();
+  return CBackgroundRunnerGroupPtr();
+}
+
+bool CBackgroundRunnerPool::WaitForWork(DWORD timeout)
+{
+  EnterCriticalSection(m_lock);
+  m_nIdle++;
+  LeaveCriticalSection(m_lock);
+  
+  bool woken = m_workEvent.WaitMSec(timeout);
+  
+  CSingleLock lock(m_lock);
+  m_nIdle--;
+  
+  // Retire if there was nothing for us for a while.
+  if (woken == false && m_groups.empty())
+  {
+    m_nWorkers--;
+    return false;
+  }
+  
+  return true;
+}
+
+void CBackgroundRunnerPool::WorkerDone()
+{
+  CSingleLock lock(m_lock);
+  m_nWorkers--;
+}
@@ -28,6 +28,8 @@
 
 #include <vector>
 #include <set>
+#include <map>
+#include <deque>
 #include "boost/shared_ptr.hpp"
 #include "boost/foreach.hpp"
 
@@ -36,6 +38,7 @@ class CFileItem;
 typedef boost::shared_ptr<CFileItem> CFileItemPtr;
 class CFileItemList;
 class CBackgroundRunnerGroup;
+typedef boost::shared_ptr<CBackgroundRunnerGroup> CBackgroundRunnerGroupPtr;
 
 class IBackgroundLoaderObserver
 {
@@ -51,6 +54,8 @@ public:
   virtual ~CBackgroundInfoLoader();
 
   void Load(CFileItemList& items);
+  void Enqueue(const map<int, CFileItemPtr>& items);   // by position, adds to the running load, if any
+  void SetFocusItem(int position);                      // loads the items around it first
   bool IsLoading();
   void SetObserver(IBackgroundLoaderObserver* pObserver);
   void SetProgressCallback(IProgressCallback* pCallback);
@@ -64,40 +69,40 @@ public:
   IProgressCallback* GetProgressCallback() { return m_pProgressCallback; }
   IBackgroundLoaderObserver* GetObserver() { return m_pObserver; }
 
-  void OnLoaderFinished();
+  void OnLoaderFinished(CBackgroundRunnerGroup* group);
   virtual void OnLoaderStart() {};
   virtual void OnLoaderFinish() {};
   
 protected:
 
   CFileItemList *m_pVecItems;
-  vector<CFileItemPtr> m_vecItems; // FileItemList would delete the items and we only want to keep a reference.
   CCriticalSection m_lock;
 
   bool m_bRunning;
   volatile bool m_bStop;
   int  m_nRequestedThreads;
   int  m_pauseBetweenLoadsInMS;
+  int  m_nThreads;
+  int  m_focusItem;
 
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
 
-  vector<CThread *> m_workers;
-  
-  CBackgroundRunnerGroup* m_workerGroup;
+  CBackgroundRunnerGroupPtr m_workerGroup;
 };
 
 typedef boost::shared_ptr<CFileItemList> CFileItemListPtr;
 typedef boost::shared_ptr<CCriticalSection> CCriticalSectionPtr;
 
 /////////////////////////////////////////////////////////////////////////////
-class CBackgroundRunnerGroup;
+// A worker of the process-wide pool. Workers pick up items from whichever
+// group has work for them, and go away after they've been idle for a while.
+//
 class CBackgroundRunner : public CThread
 {
  public:
   
-  CBackgroundRunner(CBackgroundRunnerGroup& group)
-    : m_group(group)
+  CBackgroundRunner()
   {
     CSingleLock lock(g_lock);
     g_activeThreads.insert(this);
@@ -112,12 +117,7 @@ class CBackgroundRunner : public CThread
     g_activeThreads.erase(this);
   } 
   
-  static void StopAll()
-  {
-    CSingleLock lock(g_lock);
-    BOOST_FOREACH(CBackgroundRunner* runner, g_activeThreads)
-      runner->Stop();
-  }
+  static void StopAll();
   
   static int GetNumActive()
   {
@@ -134,150 +134,74 @@ class CBackgroundRunner : public CThread
   
  private:
   
-  CBackgroundRunnerGroup& m_group;
-  
   static CCriticalSection        g_lock;
   static set<CBackgroundRunner*> g_activeThreads;
 };
 
 /////////////////////////////////////////////////////////////////////////////
-class CBackgroundInfoLoader;
+// The items of one Load() call. Several pool workers may work on a group at
+// once, up to the number of threads the loader asked for. Stopping a group
+// drops whatever is still queued; items already being loaded finish.
+//
 class CBackgroundRunnerGroup
 {
  public:
-  CBackgroundRunnerGroup(CBackgroundInfoLoader* loader, CFileItemList& items, int numThreads, int msBetweenLoads)
-    : m_msBetweenLoads(msBetweenLoads)
-    , m_nActiveThreads(numThreads)
-    , m_loader(loader)
-    , m_stopped(false)
-  {
-    if (items.Size() > 0)
-    {
-      // Copy the list.
-      for (int n=0; n<items.Size(); n++)
-        m_vecItems.push_back(items[n]);
-      
-      // Notify of the start.
-      m_loader->OnLoaderStart();
-      
-      // Start the threads.
-      CSingleLock lock(m_lock);
-      for (int i=0; i<numThreads; i++)
-      {
-        CBackgroundRunner* runner = new CBackgroundRunner(*this);
-        m_runners.insert(runner);
-      }
-    }
-  }
-  
-  ~CBackgroundRunnerGroup()
-  {
-    CSingleLock lock(m_lock);
-  }
+  CBackgroundRunnerGroup(CBackgroundInfoLoader* loader, int numThreads, int msBetweenLoads);
   
-  void Stop()
-  {
-    CSingleLock lock(m_lock);
-    m_stopped = true;
-    
-    BOOST_FOREACH(CBackgroundRunner* runner, m_runners)
-      runner->Stop();
-  }
+  void Stop();
+  void Detach();
   
-  void Detach()
-  {
-    CSingleLock lock(m_lock);
-    m_loader = 0;
-  }
-  
-  CFileItemPtr PopItem()
-  {
-    // Pull the first item off the stack.
-    CFileItemPtr pItem;
-    
-    CSingleLock lock(m_lock);
-    vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-    if (iter != m_vecItems.end())
-    {
-      pItem = *iter;
-      m_vecItems.erase(iter);
-    }
-
-    return pItem;
-  }
+  // Returns false if the group has already finished, in which case it won't take more work.
+  bool AddItem(const CFileItemPtr& item, int position);
+  bool AddItems(const map<int, CFileItemPtr>& items);
+  void SetFocusItem(int position);
   
-  bool LoadItem(CFileItemPtr& item)
-  {
-    EnterCriticalSection(m_lock);
-    if (m_loader && m_stopped == false)
-    {
-      if (m_loader->GetProgressCallback() == 0 || m_loader->GetProgressCallback()->Abort() == false)
-      {
-        CBackgroundInfoLoader* loader = m_loader;
-
-        // Leave the critical section to load the item.
-        LeaveCriticalSection(m_lock);
-        bool ret = loader->LoadItem(item.get());
-        EnterCriticalSection(m_lock);
-        
-        if (ret)
-        {
-          // Notify the observer.
-          NotifyObserver(item);
-          
-          // Pause if it was requested.
-          if (m_msBetweenLoads > 0 && m_stopped == false)
-            ::usleep(m_msBetweenLoads*1000);
-        }
-      }
-    }
-    
-    LeaveCriticalSection(m_lock);
-    return false;
-  }
+  // Called by the pool workers.
+  CFileItemPtr PopItem();
+  void LoadItem(CFileItemPtr& item);
+  void ItemDone();
   
-  void NotifyObserver(CFileItemPtr& item)
-  {
-    CSingleLock lock(m_lock);
-    if (m_stopped == false && m_loader->GetObserver())
-      m_loader->GetObserver()->OnItemLoaded(item.get());
-  }
+  bool IsFinished();
+  int GetMaxThreads() const { return m_maxThreads; }
   
-  void WorkerDone(CBackgroundRunner* worker)
-  {
-    EnterCriticalSection(m_lock);
-    m_runners.erase(worker);
-    
-    // If we're the last one on, turn the lights off.
-    if (--m_nActiveThreads == 0)
-    {
-      // We don't want to hold this lock, because otherwise we'll have taken 
-      // locks in the opposite order.
-      //
-      CBackgroundInfoLoader* loader = m_loader;
-      LeaveCriticalSection(m_lock);
-      
-      if (loader)
-        loader->OnLoaderFinished();
-
-      delete this;
-    }
-    else
-    {
-      LeaveCriticalSection(m_lock);
-    }
-  }
+ private:
   
-  int GetNumActiveThreads() 
-  { 
-    return m_nActiveThreads; 
-  }
+  void NotifyObserver(CFileItemPtr& item);
   
   CBackgroundInfoLoader*      m_loader;
   int                         m_msBetweenLoads;
-  int                         m_nActiveThreads;
-  vector<CFileItemPtr>        m_vecItems;
+  int                         m_maxThreads;
+  int                         m_nBusy;
+  int                         m_focus;
+  map<int, CFileItemPtr>      m_pending; // by position in the list
   CCriticalSection            m_lock;
-  set<CBackgroundRunner* >    m_runners;
   bool                        m_stopped;
+  bool                        m_finished;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// The queue of groups with work, shared by all loaders. The most recently
+// added group is served first, as it's the one the user is looking at.
+//
+class CBackgroundRunnerPool
+{
+ public:
+  static CBackgroundRunnerPool& Get();
+  
+  void AddGroup(const CBackgroundRunnerGroupPtr& group);
+  void Signal();
+  
+  // Called by the pool workers.
+  CBackgroundRunnerGroupPtr GetWork(CFileItemPtr& item);
+  bool WaitForWork(DWORD timeout);
+  void WorkerDone();
+  
+ private:
+  CBackgroundRunnerPool();
+  
+  deque<CBackgroundRunnerGroupPtr> m_groups;
+  CCriticalSection                 m_lock;
+  CEvent                           m_workEvent;
+  int                              m_nWorkers;
+  int                              m_nIdle;
 };
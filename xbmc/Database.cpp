@@ -24,10 +24,12 @@
 #include "Util.h"
 #include "Settings.h"
 
+using namespace std;
 using namespace AUTOPTR;
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+#define MAX_SEARCH_WORDS_PER_INSERT 100
 
 CDatabase::CDatabase(void)
 {
@@ -360,3 +362,173 @@ bool CDatabase::UpdateVersionNumber()
   return true;
 }
 
+
+void CDatabase::CreateSearchIndex()
+{
+  // Words are stored in lowercase so that a prefix search is a range scan on idxSearchWord.
+  CLog::Log(LOGINFO, "create searchindex table");
+  m_pDS->exec("CREATE TABLE searchindex ( strWord text, iType integer, idItem integer, iPos integer)\n");
+  m_pDS->exec("CREATE INDEX idxSearchWord ON searchindex(iType, strWord)");
+  m_pDS->exec("CREATE INDEX idxSearchItem ON searchindex(iType, idItem)");
+}
+
+bool CDatabase::SetSearchText(int iType, long idItem, const CStdString& strText)
+{
+  try
+  {
+    CStdString strSQL = FormatSQL("delete from searchindex where iType=%i and idItem=%ld", iType, idItem);
+    m_pDS->exec(strSQL.c_str());
+
+    vector<CStdString> words;
+    SplitSearchWords(strText, words);
+
+    // each word is stored once, at the position it first appears
+    set<CStdString> added;
+    CStdString strInsert;
+    int iCount = 0;
+    for (unsigned int i = 0; i < words.size(); i++)
+    {
+      if (!added.insert(words[i]).second)
+        continue;
+
+      if (strInsert.IsEmpty())
+        strInsert = "insert into searchindex (strWord, iType, idItem, iPos) ";
+      else
+        strInsert += " union all ";
+      strInsert += FormatSQL("select '%s',%i,%ld,%i", words[i].c_str(), iType, idItem, i);
+
+      if (++iCount == MAX_SEARCH_WORDS_PER_INSERT)
+      {
+        m_pDS->exec(strInsert.c_str());
+        strInsert.Empty();
+        iCount = 0;
+      }
+    }
+    if (!strInsert.IsEmpty())
+      m_pDS->exec(strInsert.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i, %ld) failed", __FUNCTION__, iType, idItem);
+  }
+  return false;
+}
+
+bool CDatabase::RebuildSearchIndex(int iType, const CStdString& strSQL)
+{
+  // strSQL selects the id and the text of every item of the type
+  try
+  {
+    CStdString strDelete = FormatSQL("delete from searchindex where iType=%i", iType);
+    m_pDS->exec(strDelete.c_str());
+
+    m_pDS2->query(strSQL.c_str());
+    while (!m_pDS2->eof())
+    {
+      if (!SetSearchText(iType, m_pDS2->fv(0).get_asLong(), m_pDS2->fv(1).get_asString()))
+      {
+        m_pDS2->close();
+        return false;
+      }
+      m_pDS2->next();
+    }
+    m_pDS2->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strSQL.c_str());
+  }
+  return false;
+}
+
+static CStdString GetSearchWordRange(const CStdString& strWord)
+{
+  // everything starting with the word sorts between the word and the word with its last byte bumped
+  CStdString strEnd(strWord);
+  while (!strEnd.IsEmpty() && (unsigned char)strEnd[strEnd.size() - 1] == 0xff)
+    strEnd.Delete(strEnd.size() - 1);
+
+  if (strEnd.IsEmpty())
+    return CDatabase::FormatSQL("strWord>='%s'", strWord.c_str());
+
+  strEnd.SetAt(strEnd.size() - 1, strEnd[strEnd.size() - 1] + 1);
+  return CDatabase::FormatSQL("strWord>='%s' and strWord<'%s'", strWord.c_str(), strEnd.c_str());
+}
+
+CStdString CDatabase::GetSearchSQL(int iType, const CStdString& strSearch, bool bFromStart)
+{
+  // Returns a select of (idItem, exact, pos) for the items having a word starting with each
+  // of the words searched for, or an empty string if nothing was searched for. Order by
+  // "exact desc, pos" to rank whole word matches first, then the earliest in the text.
+  // With bFromStart the first word searched for has to be the first word of the text.
+  vector<CStdString> words;
+  SplitSearchWords(strSearch, words);
+
+  // a word which is the start of another one doesn't narrow anything down
+  vector<CStdString> terms;
+  for (unsigned int i = 0; i < words.size(); i++)
+  {
+    bool bRedundant = false;
+    for (unsigned int j = 0; j < words.size() && !bRedundant && !(bFromStart && i == 0); j++)
+    {
+      if (j != i && words[j].size() >= words[i].size() && words[j].Left(words[i].size()) == words[i])
+        bRedundant = words[j].size() > words[i].size() || j < i;
+    }
+    if (!bRedundant)
+      terms.push_back(words[i]);
+  }
+  if (terms.empty())
+    return "";
+
+  // the longest word is likely the most selective, so it drives the query and the ranking
+  unsigned int iDriver = 0;
+  for (unsigned int i = 1; i < terms.size(); i++)
+  {
+    if (terms[i].size() > terms[iDriver].size())
+      iDriver = i;
+  }
+
+  CStdString strSQL = FormatSQL("select idItem, max(strWord='%s') as exact, min(iPos) as pos from searchindex "
+                                "where iType=%i and ", terms[iDriver].c_str(), iType) + GetSearchWordRange(terms[iDriver]);
+  if (bFromStart && iDriver == 0)
+    strSQL += " and iPos=0";
+
+  for (unsigned int i = 0; i < terms.size(); i++)
+  {
+    if (i == iDriver)
+      continue;
+
+    strSQL += FormatSQL(" and idItem in (select idItem from searchindex where iType=%i and ", iType) + GetSearchWordRange(terms[i]);
+    if (bFromStart && i == 0)
+      strSQL += " and iPos=0";
+    strSQL += ")";
+  }
+  strSQL += " group by idItem";
+
+  return strSQL;
+}
+
+void CDatabase::SplitSearchWords(const CStdString& strText, vector<CStdString>& words)
+{
+  // Anything but letters and digits separates words. Apostrophes are dropped so that
+  // "don't" matches "dont", and non-ASCII (UTF-8) bytes are kept as part of the word.
+  CStdString strWord;
+  for (unsigned int i = 0; i <= strText.size(); i++)
+  {
+    unsigned char c = i < strText.size() ? strText[i] : ' ';
+    if (c == '\'')
+      continue;
+
+    if (c >= 0x80)
+      strWord += (char)c;
+    else if (isalnum(c))
+      strWord += (char)tolower(c);
+    else if (!strWord.IsEmpty())
+    {
+      words.push_back(strWord);
+      strWord.Empty();
+    }
+  }
+}
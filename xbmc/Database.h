@@ -23,6 +23,8 @@
 
 #include "lib/sqLite/sqlitedataset.h"
 
+#include <vector>
+
 class CDatabase
 {
 public:
@@ -47,6 +49,14 @@ protected:
   virtual bool CreateTables();
   virtual bool UpdateOldVersion(int version);
 
+  // Word index used by the search functions instead of like '%term%' scans.
+  // Items are identified by a type (defined by each database) and their id.
+  virtual void CreateSearchIndex();
+  bool SetSearchText(int iType, long idItem, const CStdString& strText);
+  bool RebuildSearchIndex(int iType, const CStdString& strSQL);
+  CStdString GetSearchSQL(int iType, const CStdString& strSearch, bool bFromStart=false);
+  static void SplitSearchWords(const CStdString& strText, std::vector<CStdString>& words);
+
   bool m_bOpen;
   int m_version;
 //#ifdef PRE_2_1_DATABASE_COMPATIBILITY
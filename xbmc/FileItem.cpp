@@ -46,6 +46,7 @@
 #include "Song.h"
 #include "URL.h"
 #include "Settings.h"
+#include "PlexImageCache.h"
 #include "CocoaUtils.h"
 
 using namespace std;
@@ -2750,16 +2751,8 @@ CStdString CFileItem::CacheBanner() const
   if (m_strBannerUrl.size() > 0)
   {
     CStdString localBanner = GetCachedPlexMediaServerBanner();
-    if (CFile::Exists(localBanner) == false)
-    {
-      CPicture pic;
-      pic.CacheImage(m_strBannerUrl, localBanner);
-      return localBanner;
-    }
-    else
-    {
-      return localBanner;
-    }
+    CPlexImageCache::Get()->CacheImage(m_strBannerUrl, localBanner);
+    return localBanner;
   }
   
   return "";
@@ -2774,16 +2767,8 @@ CStdString CFileItem::CacheFanart(bool probe) const
   if (m_strFanartUrl.size() > 0)
   {
     CStdString localFanart = GetCachedPlexMediaServerFanart(m_strFanartUrl);
-    if (CFile::Exists(localFanart) == false)
-    {
-      CPicture pic;
-      pic.CacheImage(m_strFanartUrl, localFanart);
-      return localFanart;
-    }
-    else
-    {
-      return localFanart;
-    }
+    CPlexImageCache::Get()->CacheImage(m_strFanartUrl, localFanart);
+    return localFanart;
   }
   
   if (IsVideoDb())
@@ -3242,7 +3227,7 @@ void CFileItem::SetQuickFanart(const CStdString& fanartURL)
   m_strFanartUrl = fanartURL;
   
   // See if it's already cached, and the cached version isn't too old.
-  if (CFile::Exists(GetCachedPlexMediaServerFanart()))
+  if (CPlexImageCache::Get()->Exists(GetCachedPlexMediaServerFanart()))
     SetProperty("fanart_image", GetCachedPlexMediaServerFanart());
 }
 
@@ -3251,7 +3236,7 @@ void CFileItem::SetQuickBanner(const CStdString& bannerURL)
   m_strBannerUrl = bannerURL;
   
   // See if it's already cached, and the cached version isn't too old.
-  if (CFile::Exists(GetCachedPlexMediaServerBanner()))
+  if (CPlexImageCache::Get()->Exists(GetCachedPlexMediaServerBanner()))
     SetProperty("banner_image", GetCachedPlexMediaServerBanner());
 }
 
@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "BlockCache.h"
+
+using namespace XFILE;
+
+CBlockCache::CBlockCache(unsigned int maxSize)
+{
+  m_maxBlocks = maxSize / BLOCK_SIZE;
+  if (m_maxBlocks < 2)
+    m_maxBlocks = 2;
+}
+
+CBlockCache::~CBlockCache()
+{
+  Clear();
+}
+
+void CBlockCache::Clear()
+{
+  for (MAPBLOCKS::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    delete[] it->second.data;
+  m_blocks.clear();
+  m_lru.clear();
+}
+
+CBlockCache::CBlock* CBlockCache::GetBlock(__int64 index, bool create)
+{
+  MAPBLOCKS::iterator it = m_blocks.find(index);
+  if (it != m_blocks.end())
+  {
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return &it->second;
+  }
+
+  if (!create)
+    return NULL;
+
+  char* data = NULL;
+  if (m_blocks.size() >= m_maxBlocks)
+  {
+    // reuse the memory of the block nobody has asked for in the longest time
+    MAPBLOCKS::iterator victim = m_blocks.find(m_lru.back());
+    data = victim->second.data;
+    m_blocks.erase(victim);
+    m_lru.pop_back();
+  }
+  else
+    data = new char[BLOCK_SIZE];
+
+  m_lru.push_front(index);
+
+  CBlock& block = m_blocks[index];
+  block.data  = data;
+  block.begin = 0;
+  block.end   = 0;
+  block.lru   = m_lru.begin();
+  return &block;
+}
+
+unsigned int CBlockCache::Read(__int64 pos, char* buffer, unsigned int size)
+{
+  unsigned int done = 0;
+  while (done < size)
+  {
+    CBlock* block = GetBlock(pos / BLOCK_SIZE, false);
+    unsigned int offset = (unsigned int)(pos % BLOCK_SIZE);
+    if (!block || offset < block->begin || offset >= block->end)
+      break;
+
+    unsigned int amount = block->end - offset;
+    if (amount > size - done)
+      amount = size - done;
+
+    memcpy(buffer + done, block->data + offset, amount);
+    done += amount;
+    pos  += amount;
+
+    // the rest is in the next block, if this one was filled to its end
+    if (block->end != BLOCK_SIZE)
+      break;
+  }
+  return done;
+}
+
+void CBlockCache::Write(__int64 pos, const char* buffer, unsigned int size)
+{
+  while (size > 0)
+  {
+    CBlock* block = GetBlock(pos / BLOCK_SIZE, true);
+    unsigned int offset = (unsigned int)(pos % BLOCK_SIZE);
+    unsigned int amount = BLOCK_SIZE - offset;
+    if (amount > size)
+      amount = size;
+
+    bool keep = true;
+    if (block->begin == block->end)
+    {
+      block->begin = offset;
+      block->end   = offset + amount;
+    }
+    else if (offset <= block->end && offset + amount >= block->begin)
+    {
+      if (offset < block->begin)
+        block->begin = offset;
+      if (offset + amount > block->end)
+        block->end = offset + amount;
+    }
+    else if (amount > block->end - block->begin)
+    {
+      // a block only keeps one range, the bigger one wins
+      block->begin = offset;
+      block->end   = offset + amount;
+    }
+    else
+      keep = false;
+
+    if (keep)
+      memcpy(block->data + offset, buffer, amount);
+
+    buffer += amount;
+    pos    += amount;
+    size   -= amount;
+  }
+}
+
+unsigned int CBlockCache::GetCachedAhead(__int64 pos, unsigned int limit)
+{
+  unsigned int done = 0;
+  while (done < limit)
+  {
+    MAPBLOCKS::iterator it = m_blocks.find(pos / BLOCK_SIZE);
+    unsigned int offset = (unsigned int)(pos % BLOCK_SIZE);
+    if (it == m_blocks.end() || offset < it->second.begin || offset >= it->second.end)
+      break;
+
+    done += it->second.end - offset;
+    pos  += it->second.end - offset;
+    if (it->second.end != BLOCK_SIZE)
+      break;
+  }
+  return done < limit ? done : limit;
+}
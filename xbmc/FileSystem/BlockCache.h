@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <list>
+#include <map>
+
+namespace XFILE
+{
+  // Remembers the parts of a file which have been read, in fixed size blocks addressed by
+  // their offset in the file, so they can be read again without fetching them. Only as many
+  // blocks as fit the size given are kept, the least recently used ones go first.
+  // Not thread safe, it belongs to the one file reading through it.
+  class CBlockCache
+  {
+  public:
+    enum { BLOCK_SIZE = 64 * 1024 };
+
+    CBlockCache(unsigned int maxSize);
+    ~CBlockCache();
+
+    // copies what's cached from pos on, returns how many bytes that was
+    unsigned int Read(__int64 pos, char* buffer, unsigned int size);
+
+    // remembers size bytes read at pos
+    void Write(__int64 pos, const char* buffer, unsigned int size);
+
+    // how many bytes from pos on can be read without a gap, looking no further than limit
+    unsigned int GetCachedAhead(__int64 pos, unsigned int limit);
+
+    void Clear();
+
+  private:
+    struct CBlock
+    {
+      char*        data;
+      unsigned int begin;  // the valid bytes in the block
+      unsigned int end;
+      std::list<__int64>::iterator lru;
+    };
+
+    typedef std::map<__int64, CBlock> MAPBLOCKS;
+
+    CBlock* GetBlock(__int64 index, bool create);
+
+    MAPBLOCKS          m_blocks;
+    std::list<__int64> m_lru;       // most recently used first
+    unsigned int       m_maxBlocks;
+  };
+}
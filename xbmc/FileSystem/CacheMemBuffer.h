@@ -23,8 +23,7 @@
 #define CACHEMEMBUFFER_H
 
 #include "CacheStrategy.h"
-#include "utils/CriticalSection.h"
-#include "RingBuffer.h"
+#include "LockFreeRingBuffer.h"
 
 /**
 	@author Team XBMC
@@ -41,6 +40,8 @@ public:
     virtual int Close();
 
     virtual int WriteToCache(const char *pBuffer, size_t iSize) ;
+    virtual char *GetWriteBuffer(size_t &iSize) ;
+    virtual void CommitWrite(size_t iSize) ;
     virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) ;
     virtual __int64 WaitForData(unsigned int iMinAvail, unsigned int iMillis) ;
 
@@ -48,11 +49,10 @@ public:
 	virtual void Reset(__int64 iSourcePosition) ;
 
 protected:
+    // the filling thread only writes to the buffer, everything else is the reader's.
+    // Reset is the exception, it comes from the filling thread while the reader waits for the seek.
     __int64 m_nStartPosition;
-    CRingBuffer m_buffer;
-    CRingBuffer m_HistoryBuffer;
-    CRingBuffer m_forwardBuffer; // for seek cases, to store data already read
-    CCriticalSection m_sync;
+    CLockFreeRingBuffer m_buffer;  // keeps what was read last, to seek back into
 };
 
 } // namespace XFILE
@@ -58,6 +58,12 @@ public:
 	virtual int Close() = 0;
 
 	virtual int WriteToCache(const char *pBuffer, size_t iSize) = 0;
+
+  // lets the source be read straight into the cache. returns NULL if the strategy can't hand
+  // out its memory, otherwise up to iSize bytes can be filled and passed to CommitWrite.
+  virtual char *GetWriteBuffer(size_t &iSize) { return NULL; }
+  virtual void CommitWrite(size_t iSize) { }
+
 	virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
 	virtual __int64 WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
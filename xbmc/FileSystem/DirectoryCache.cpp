@@ -24,6 +24,8 @@
 #include "Util.h"
 #include "Settings.h"
 #include "FileItem.h"
+#include "VideoInfoTag.h"
+#include "MusicInfoTag.h"
 
 using namespace std;
 using namespace DIRECTORY;
@@ -34,6 +36,7 @@ CDirectoryCache::CDir::CDir(const CStdString &strPath, DIR_CACHE_TYPE cacheType)
 {
   m_strPath = strPath;
   m_cacheType = cacheType;
+  m_size = 0;
   m_Items = new CFileItemList;
   m_Items->SetFastLookup(true);
 }
@@ -45,12 +48,15 @@ CDirectoryCache::CDir::~CDir()
 
 CDirectoryCache::CDirectoryCache(void)
 {
+  m_size = 0;
   m_iThumbCacheRefCount = 0;
   m_iMusicThumbCacheRefCount = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void)
 {
+  for (imapCache i = m_cache.begin(); i != m_cache.end(); i++)
+    delete i->second;
 }
 
 bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &items) const
@@ -60,14 +66,15 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
   CStdString storedPath = _P(strPath);
   CUtil::RemoveSlashAtEnd(storedPath);
 
-  for (civecCache i = m_vecCache.begin(); i != m_vecCache.end(); i++)
+  cimapCache i = m_cache.find(storedPath);
+  if (i != m_cache.end() && i->second->m_cacheType == DIR_CACHE_ALWAYS)
   {
-    const CDir* dir = *i;
-    if (dir->m_strPath == storedPath && dir->m_cacheType == DIR_CACHE_ALWAYS)
-    {
-      items.Assign(*dir->m_Items);
-      return true;
-    }
+    const CDir* dir = i->second;
+    items.Assign(*dir->m_Items);
+
+    // it's now the most recently used
+    m_lru.splice(m_lru.begin(), m_lru, dir->m_lru);
+    return true;
   }
   return false;
 }
@@ -97,7 +104,14 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
 
   CDir* dir = new CDir(storedPath, cacheType);
   dir->m_Items->Assign(items);
-  m_vecCache.push_back(dir);
+  dir->m_size = EstimateSize(*dir->m_Items);
+
+  m_cache[storedPath] = dir;
+  dir->m_lru = m_lru.insert(m_lru.begin(), dir);
+  dir->m_history = m_history.insert(m_history.end(), dir);
+  m_size += dir->m_size;
+
+  Evict();
 }
 
 void CDirectoryCache::ClearDirectory(const CStdString& strPath)
@@ -107,16 +121,7 @@ void CDirectoryCache::ClearDirectory(const CStdString& strPath)
   CStdString storedPath = _P(strPath);
   CUtil::RemoveSlashAtEnd(storedPath);
 
-  for (ivecCache i = m_vecCache.begin(); i != m_vecCache.end(); i++)
-  {
-    CDir* dir = *i;
-    if (dir->m_strPath == storedPath)
-    {
-      delete dir;
-      m_vecCache.erase(i);
-      return;
-    }
-  }
+  Delete(storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
@@ -126,28 +131,26 @@ void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
   CStdString storedPath = _P(strPath);
   CUtil::RemoveSlashAtEnd(storedPath);
 
-  ivecCache i = m_vecCache.begin();
-  for (bool found=false; i != m_vecCache.end(); )
+  // everything cached after this directory goes
+  imapCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
   {
-    CDir* dir = *i;
-    if (found)
-    {
-      i = m_vecCache.erase(i);
-      delete dir;
-    }
-    else if (strncmp(dir->m_strPath.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0 &&
-             dir->m_strPath.size() > storedPath.size())
+    list<CDir*>::iterator it = i->second->m_history;
+    for (++it; it != m_history.end(); )
     {
-      i = m_vecCache.erase(i);
-      delete dir;
+      CStdString path = (*it)->m_strPath;
+      ++it;
+      Delete(path);
     }
-    else
-    {
-      i++;
-    }
-    
-    if (storedPath == dir->m_strPath)
-      found = true;
+  }
+
+  // as do all the sub paths, which follow it in the index
+  i = m_cache.upper_bound(storedPath);
+  while (i != m_cache.end() && strncmp(i->first.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
+  {
+    CStdString path = i->first;
+    ++i;
+    Delete(path);
   }
 }
 
@@ -164,15 +167,12 @@ bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache) cons
   CUtil::GetDirectory(translatedFile, strPath);
   CUtil::RemoveSlashAtEnd(strPath);
 
-  for (civecCache i = m_vecCache.begin(); i != m_vecCache.end(); i++)
+  cimapCache i = m_cache.find(strPath);
+  if (i != m_cache.end())
   {
-    const CDir* dir = *i;
-    if (dir->m_strPath == strPath)
-    {
-      bInCache = true;
-      if (dir->m_Items->Contains(translatedFile))
-        return true;
-    }
+    bInCache = true;
+    if (i->second->m_Items->Contains(translatedFile))
+      return true;
   }
   return false;
 }
@@ -182,17 +182,13 @@ void CDirectoryCache::Clear()
   // this routine clears everything except things we always cache
   CSingleLock lock (m_cs);
 
-  ivecCache i = m_vecCache.begin();
-  while (i != m_vecCache.end() )
+  imapCache i = m_cache.begin();
+  while (i != m_cache.end())
   {
-    CDir* dir = *i;
-    if (!IsCacheDir(dir->m_strPath))
-    {
-      delete dir;
-      i = m_vecCache.erase(i);
-    }
-    else
-      i++;
+    CStdString path = i->first;
+    ++i;
+    if (!IsCacheDir(path))
+      Delete(path);
   }
 }
 
@@ -210,18 +206,9 @@ void CDirectoryCache::InitCache(set<CStdString>& dirs)
 
 void CDirectoryCache::ClearCache(set<CStdString>& dirs)
 {
-  ivecCache i = m_vecCache.begin();
-  while (i != m_vecCache.end() )
-  {
-    CDir* dir = *i;
-    if (dirs.find(dir->m_strPath) != dirs.end())
-    {
-      delete dir;
-      m_vecCache.erase(i);
-    }
-    else
-      i++;
-  }
+  set<CStdString>::iterator it;
+  for (it = dirs.begin(); it != dirs.end(); ++it)
+    Delete(*it);
 }
 
 bool CDirectoryCache::IsCacheDir(const CStdString &strPath) const
@@ -234,6 +221,65 @@ bool CDirectoryCache::IsCacheDir(const CStdString &strPath) const
   return true;
 }
 
+void CDirectoryCache::Delete(const CStdString& storedPath)
+{
+  imapCache i = m_cache.find(storedPath);
+  if (i == m_cache.end())
+    return;
+
+  CDir* dir = i->second;
+  m_lru.erase(dir->m_lru);
+  m_history.erase(dir->m_history);
+  m_size -= dir->m_size;
+  m_cache.erase(i);
+  delete dir;
+}
+
+void CDirectoryCache::Evict()
+{
+  if (g_advancedSettings.m_iDirectoryCacheSize <= 0)
+    return;
+
+  unsigned int budget = (unsigned int)g_advancedSettings.m_iDirectoryCacheSize * 1024;
+
+  // drop the least recently used directories until we're back within budget, but
+  // never the one most recently used, and never the ones we always cache.
+  list<CDir*>::iterator it = m_lru.end();
+  while (m_size > budget && it != m_lru.begin())
+  {
+    --it;
+    if (it == m_lru.begin())
+      break;
+
+    CDir* dir = *it;
+    if (IsCacheDir(dir->m_strPath))
+      continue;
+
+    ++it;
+    Delete(dir->m_strPath);
+  }
+}
+
+unsigned int CDirectoryCache::EstimateSize(const CFileItemList& items)
+{
+  // only the bulk of it, the strings and tags of each item
+  unsigned int size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    size += sizeof(CFileItem);
+    size += item->m_strPath.size();
+    size += item->GetLabel().size() + item->GetLabel2().size();
+    size += item->GetThumbnailImage().size() + item->GetIconImage().size();
+
+    if (item->HasVideoInfoTag())
+      size += sizeof(CVideoInfoTag) + item->GetVideoInfoTag()->m_strPlot.size();
+    if (item->HasMusicInfoTag())
+      size += sizeof(MUSIC_INFO::CMusicInfoTag);
+  }
+  return size;
+}
+
 void CDirectoryCache::InitThumbCache()
 {
   CSingleLock lock (m_cs);
@@ -24,6 +24,8 @@
 #include "Directory.h"
 
 #include <set>
+#include <map>
+#include <list>
 
 class CFileItem;
 
@@ -39,6 +41,9 @@ namespace DIRECTORY
       CStdString m_strPath;
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      unsigned int m_size;                  // rough estimate of the memory held, in bytes
+      std::list<CDir*>::iterator m_lru;     // position in m_lru
+      std::list<CDir*>::iterator m_history; // position in m_history
     };
   public:
     CDirectoryCache(void);
@@ -58,9 +63,20 @@ namespace DIRECTORY
     void ClearCache(std::set<CStdString>& dirs);
     bool IsCacheDir(const CStdString &strPath) const;
 
-    std::vector<CDir*> m_vecCache;
-    typedef std::vector<CDir*>::iterator ivecCache;
-    typedef std::vector<CDir*>::const_iterator civecCache;
+    void Delete(const CStdString& storedPath);
+    void Evict();
+    static unsigned int EstimateSize(const CFileItemList& items);
+
+    // Cached directories by path. Being sorted, all the sub paths of a
+    // directory directly follow it, which is what ClearSubPaths() relies on.
+    typedef std::map<CStdString, CDir*> MAPCACHE;
+    typedef MAPCACHE::iterator imapCache;
+    typedef MAPCACHE::const_iterator cimapCache;
+    MAPCACHE m_cache;
+
+    mutable std::list<CDir*> m_lru;   // most recently used first
+    std::list<CDir*> m_history;       // in the order they were cached
+    unsigned int m_size;              // total of the estimated sizes
 
     CCriticalSection m_cs;
     std::set<CStdString> m_thumbDirs;
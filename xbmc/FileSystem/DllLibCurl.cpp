@@ -70,6 +70,26 @@ void DllLibCurlGlobal::Unload()
   }
 }
 
+/* maximum number of idle sessions kept alive per server, enough to cover */
+/* a burst of thumbnail requests from the background loaders */
+#define MAX_IDLE_SESSIONS 8
+
+DllLibCurlGlobal::VEC_CURLSESSIONS::iterator DllLibCurlGlobal::CloseSession(VEC_CURLSESSIONS::iterator it)
+{
+  CLog::Log(LOGINFO, "%s - Closing session to %s://%s:%d (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), it->m_port, (void*)it->m_easy, (void*)it->m_multi);
+
+  // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
+  // code accesses stuff in the easy's structure.
+  if(it->m_multi)
+    multi_cleanup(it->m_multi);
+  if(it->m_easy)
+    easy_cleanup(it->m_easy);
+
+  Unload();
+
+  return m_sessions.erase(it);
+}
+
 void DllLibCurlGlobal::CheckIdle()
 {
   CSingleLock lock(m_critSection);
@@ -81,65 +101,63 @@ void DllLibCurlGlobal::CheckIdle()
   {
     if( !it->m_busy && it->m_idletimestamp + idletime < GetTickCount())
     {
-      CLog::Log(LOGINFO, "%s - Closing session to %s ://%s (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), (void*)it->m_easy, (void*)it->m_multi);
-
-      // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
-      // code accesses stuff in the easy's structure.
-      if(it->m_multi)
-        multi_cleanup(it->m_multi);
-      if(it->m_easy)
-        easy_cleanup(it->m_easy);
-
-      Unload();
-
-      it = m_sessions.erase(it);
+      it = CloseSession(it);
       continue;
     }
     it++;
   }
 }
 
-void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle)
+void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, int port, CURL_HANDLE** easy_handle, CURLM** multi_handle)
 {
   assert(easy_handle != NULL);
 
   CSingleLock lock(m_critSection);
 
-  VEC_CURLSESSIONS::iterator it;
+  /* allow reuse of requester is trying to connect to same server, */
+  /* curl will take care of any differences in username/password.  */
+  /* pick the most recently used one, it's the most likely to still */
+  /* have a live keep-alive connection in its connection cache      */
+  VEC_CURLSESSIONS::iterator it, best = m_sessions.end();
   for(it = m_sessions.begin(); it != m_sessions.end(); it++)
   {
-    if( !it->m_busy )
+    if( !it->m_busy 
+     && it->m_port == port
+     && it->m_protocol.compare(protocol) == 0 
+     && it->m_hostname.compare(hostname) == 0 )
     {
-      /* allow reuse of requester is trying to connect to same host */
-      /* curl will take care of any differences in username/password */
-      if(false && it->m_protocol.compare(protocol) == 0 && it->m_hostname.compare(hostname) == 0)
-      {
-        it->m_busy = true;
-        if(easy_handle)
-        {
-          if(!it->m_easy)
-            it->m_easy = easy_init();
-
-          *easy_handle = it->m_easy;
-        }
-
-        if(multi_handle)
-        {
-          if(!it->m_multi)
-            it->m_multi = multi_init();
-
-          *multi_handle = it->m_multi;
-        }
-
-        return;
-      }
+      if(best == m_sessions.end() || it->m_idletimestamp > best->m_idletimestamp)
+        best = it;
     }
   }
 
+  if(best != m_sessions.end())
+  {
+    best->m_busy = true;
+    if(easy_handle)
+    {
+      if(!best->m_easy)
+        best->m_easy = easy_init();
+
+      *easy_handle = best->m_easy;
+    }
+
+    if(multi_handle)
+    {
+      if(!best->m_multi)
+        best->m_multi = multi_init();
+
+      *multi_handle = best->m_multi;
+    }
+
+    return;
+  }
+
   SSession session = {};
   session.m_busy = true;
   session.m_protocol = protocol;
   session.m_hostname = hostname;
+  session.m_port = port;
 
   /* count up global interface counter */
   Load();
@@ -159,7 +177,7 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
   m_sessions.push_back(session);
 
 
-  CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
+  CLog::Log(LOGINFO, "%s - Created session to %s://%s:%d\n", __FUNCTION__, protocol, hostname, port);
 
   return;
 
@@ -194,9 +212,40 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
       easy_reset(easy);
       it->m_busy = false;
       it->m_idletimestamp = GetTickCount();
-      return;
+      break;
     }
   }
+
+  if(it == m_sessions.end())
+    return;
+
+  /* don't let a burst of requests leave too many idle connections open */
+  /* against a single server, drop the least recently used ones instead */
+  CStdString protocol = it->m_protocol;
+  CStdString hostname = it->m_hostname;
+  int        port     = it->m_port;
+  while(true)
+  {
+    int idle = 0;
+    VEC_CURLSESSIONS::iterator oldest = m_sessions.end();
+    for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+    {
+      if( it->m_busy 
+       || it->m_port != port
+       || it->m_protocol != protocol
+       || it->m_hostname != hostname )
+        continue;
+
+      idle++;
+      if(oldest == m_sessions.end() || it->m_idletimestamp < oldest->m_idletimestamp)
+        oldest = it;
+    }
+
+    if(idle <= MAX_IDLE_SESSIONS)
+      break;
+
+    CloseSession(oldest);
+  }
 }
 
 CURL_HANDLE* DllLibCurlGlobal::easy_duphandle(CURL_HANDLE* easy_handle)
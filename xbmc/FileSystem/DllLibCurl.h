@@ -110,7 +110,7 @@ namespace XCURL
   {
   public:
     /* extend interface with buffered functions */
-    void easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle);
+    void easy_aquire(const char *protocol, const char *hostname, int port, CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HANDLE** easy_out, CURLM** multi_out);
     CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle);
@@ -126,6 +126,7 @@ namespace XCURL
       DWORD         m_idletimestamp;  // timestamp of when this object when idle
       CStdString    m_protocol;
       CStdString    m_hostname;
+      int           m_port;
       bool          m_busy;
       CURL_HANDLE*  m_easy;
       CURLM*        m_multi;
@@ -135,6 +136,9 @@ namespace XCURL
     
     VEC_CURLSESSIONS m_sessions;  
     CCriticalSection m_critSection;
+
+  protected:
+    VEC_CURLSESSIONS::iterator CloseSession(VEC_CURLSESSIONS::iterator it);
   };
 }
 
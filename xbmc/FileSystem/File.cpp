@@ -333,6 +333,8 @@ bool CFile::Open(const CStdString& strFileName, bool bBinary, unsigned int flags
       return false;
     }
 
+    m_pFile->SetReadHints(m_flags);
+
     if (m_flags & READ_BUFFERED)
     {
       if (m_pFile->GetChunkSize())
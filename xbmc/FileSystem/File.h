@@ -57,6 +57,9 @@ public:
 /* open without caching. regardless to file type. */
 #define READ_NO_CACHE  0x08
 
+/* data is only looked at once (thumbnails, scans), hint the os not to keep it in its cache */
+#define READ_ONCE      0x10
+
 class CFileStreamBuffer;
 class ICacheInterface;
 
@@ -174,7 +174,18 @@ void CFileCache::Process()
       m_seekEnded.Set();
     }
 
-    int iRead = m_source.Read(buffer.get(), chunksize);
+    // read straight into the cache when it has room for a whole chunk in one piece
+    size_t iSpace = 0;
+    char *pSpace = m_pCache->GetWriteBuffer(iSpace);
+    bool bDirect = pSpace && iSpace >= (size_t)chunksize;
+
+    int iRead = m_source.Read(bDirect ? pSpace : buffer.get(), chunksize);
+    if (bDirect && iRead > 0)
+    {
+      m_pCache->CommitWrite(iRead);
+      continue;
+    }
+
     if(iRead == 0)
     {
       CLog::Log(LOGINFO, "CFileCache::Process - Hit eof.");
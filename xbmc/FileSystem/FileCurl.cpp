@@ -44,6 +44,13 @@ using namespace XCURL;
 
 #define XMIN(a,b) ((a)<(b)?(a):(b))
 
+// the transfer is kept this many seconds of reading ahead of the reader, when it can be
+#define PREFETCH_SECONDS 4
+
+// limits of the parts fetched over extra connections
+#define SEGMENT_MIN (512 * 1024)
+#define SEGMENT_MAX (8 * 1024 * 1024)
+
 #if defined(__APPLE__)
 #include "CocoaUtilsPlus.h"
 extern "C" int __stdcall dllselect(int ntfs, fd_set *readfds, fd_set *writefds, fd_set *errorfds, const timeval *timeout);
@@ -187,6 +194,7 @@ CFileCurl::CReadState::CReadState()
 	m_fileSize = 0;
   m_bufferSize = 0;
   m_cancelled = false;
+  m_headerList = NULL;
 }
 
 CFileCurl::CReadState::~CReadState()
@@ -195,6 +203,10 @@ CFileCurl::CReadState::~CReadState()
 
   if(m_easyHandle)
     g_curlInterface.easy_release(&m_easyHandle, &m_multiHandle);
+
+  /* the handle no longer points at it once it's been released */
+  if(m_headerList)
+    g_curlInterface.slist_free_all(m_headerList);
 }
 
 bool CFileCurl::CReadState::Seek(__int64 pos)
@@ -255,6 +267,14 @@ long CFileCurl::CReadState::Connect(unsigned int size)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length))
     m_fileSize = m_filePos + (__int64)length;
   
+  long response;
+  if (CURLE_OK != g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response))
+    response = -1;
+
+  // A conditional request that wasn't modified comes back without a body.
+  if (response == 304)
+    return response;
+  
   // If we started at the end of the file, then we're of course not able to read a single byte.
   if (m_fileSize != m_filePos && couldFillBuffer == false)
   {
@@ -262,11 +282,7 @@ long CFileCurl::CReadState::Connect(unsigned int size)
     return -1; 
   }
 
-  long response;
-  if (CURLE_OK == g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response))
-    return response;
-
-  return -1;
+  return response;
 }
 
 void CFileCurl::CReadState::Disconnect()
@@ -292,7 +308,6 @@ CFileCurl::CFileCurl()
 {
   g_curlInterface.Load(); // loads the curl dll and resolves exports etc.
   m_curlAliasList = NULL;
-  m_curlHeaderList = NULL;
   m_opened = false;
   m_multisession  = true;
   m_seekable = true;
@@ -303,7 +318,23 @@ CFileCurl::CFileCurl()
   m_ftppasvip = false;
   m_bufferSize = 128*1024;
   m_binary = true;
+  m_httpresponse = -1;
   m_state = new CReadState();
+  m_parked = NULL;
+  m_cache = NULL;
+  m_cachePos = 0;
+  m_readAhead = 0;
+  m_readBytes = 0;
+  m_readTime = 0;
+  m_connects = 0;
+  m_segmented = false;
+  m_connections = 1;
+  m_segmentSize = SEGMENT_MIN;
+  m_connRate = 0;
+  m_connDelay = 0;
+  m_recvBytes = 0;
+  m_recvRate = 0;
+  m_waitTime = 0;
 }
 
 //Has to be called before Open()
@@ -318,16 +349,28 @@ void CFileCurl::Close()
   m_opened = false;
   m_state->Disconnect();
 
+  /* hand the session back to the pool so the next request to this */
+  /* server can reuse its keep-alive connection                     */
+  if(m_state->m_easyHandle)
+    g_curlInterface.easy_release(&m_state->m_easyHandle, &m_state->m_multiHandle);
+
+  for(unsigned int i = 0; i < m_segments.size(); i++)
+    delete m_segments[i].state;
+  m_segments.clear();
+  m_segmented = false;
+
+  delete m_parked;
+  m_parked = NULL;
+  delete m_cache;
+  m_cache = NULL;
+
   m_url.Empty();
   
   /* cleanup */
   if( m_curlAliasList )
     g_curlInterface.slist_free_all(m_curlAliasList);
-  if( m_curlHeaderList )
-    g_curlInterface.slist_free_all(m_curlHeaderList);
   
   m_curlAliasList = NULL;
-  m_curlHeaderList = NULL;
 }
 
 void CFileCurl::SetCommonOptions(CReadState* state)
@@ -368,15 +411,16 @@ void CFileCurl::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_FAILONERROR, 1);
 
   // enable support for icecast / shoutcast streams
-  m_curlAliasList = g_curlInterface.slist_append(m_curlAliasList, "ICY 200 OK"); 
+  if( !m_curlAliasList )
+    m_curlAliasList = g_curlInterface.slist_append(m_curlAliasList, "ICY 200 OK"); 
   g_curlInterface.easy_setopt(h, CURLOPT_HTTP200ALIASES, m_curlAliasList); 
 
   // never verify peer, we don't have any certificates to do this
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, m_binary ? FALSE : TRUE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, m_binary ? FALSE : TRUE);
 
   // setup any requested authentication
   if( m_ftpauth.length() > 0 )
@@ -449,22 +493,24 @@ void CFileCurl::SetCommonOptions(CReadState* state)
 
 void CFileCurl::SetRequestHeaders(CReadState* state)
 {
-  if(m_curlHeaderList) 
+  /* each transfer gets its own list, the segments and a parked connection */
+  /* may still be sending theirs while this one is set up                   */
+  if(state->m_headerList) 
   {
-    g_curlInterface.slist_free_all(m_curlHeaderList);
-    m_curlHeaderList = NULL;
+    g_curlInterface.slist_free_all(state->m_headerList);
+    state->m_headerList = NULL;
   }
 
   MAPHTTPHEADERS::iterator it;
   for(it = m_requestheaders.begin(); it != m_requestheaders.end(); it++)
   {
     CStdString buffer = it->first + ": " + it->second;
-    m_curlHeaderList = g_curlInterface.slist_append(m_curlHeaderList, buffer.c_str()); 
+    state->m_headerList = g_curlInterface.slist_append(state->m_headerList, buffer.c_str()); 
   }
 
   // add user defined headers
-  if (m_curlHeaderList && state->m_easyHandle)
-    g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_HTTPHEADER, m_curlHeaderList); 
+  if (state->m_headerList && state->m_easyHandle)
+    g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_HTTPHEADER, state->m_headerList); 
 
 }
 
@@ -623,7 +669,7 @@ bool CFileCurl::Open(const CURL& url, bool bBinary)
 
   ASSERT(!(!m_state->m_easyHandle ^ !m_state->m_multiHandle));
   if( m_state->m_easyHandle == NULL )
-    g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), &m_state->m_easyHandle, &m_state->m_multiHandle );
+    g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), url2.GetPort(), &m_state->m_easyHandle, &m_state->m_multiHandle );
 
   // setup common curl options
   SetCommonOptions(m_state);
@@ -632,6 +678,7 @@ bool CFileCurl::Open(const CURL& url, bool bBinary)
   m_opened = true;
 
   long response = m_state->Connect(m_bufferSize);
+  m_httpresponse = response;
   if( response < 0 )
     return false;
   
@@ -670,6 +717,30 @@ bool CFileCurl::Open(const CURL& url, bool bBinary)
   if(m_state->m_fileSize > 0)
     m_seekable = true;
 
+  // demuxers jump between the headers, index and data while opening and seeking, with a cache
+  // going back to what they read already doesn't need a new request
+  if(m_seekable && m_binary && g_advancedSettings.m_curlcachesize > 0)
+  {
+    m_cache = new CBlockCache(g_advancedSettings.m_curlcachesize * 1024 * 1024);
+    m_cachePos = m_state->m_filePos;
+    m_readAhead = m_bufferSize;
+    m_readBytes = 0;
+    m_readTime = timeGetTime();
+
+    // a single connection often can't carry a high bitrate over a slow link, parts further
+    // ahead are then fetched over more of them
+    m_segmented = m_multisession && m_url.Find(":31339") < 0
+               && g_advancedSettings.m_curlconnections > 1
+               && m_state->m_fileSize >= 4 * SEGMENT_MIN;
+    m_connections = 1;
+    m_segmentSize = SEGMENT_MIN;
+    m_connRate = 0;
+    m_connDelay = 0;
+    m_recvBytes = 0;
+    m_recvRate = 0;
+    m_waitTime = 0;
+  }
+
   return true;
 }
 
@@ -711,7 +782,7 @@ bool CFileCurl::Exists(const CURL& url)
 
 __int64 CFileCurl::Seek(__int64 iFilePosition, int iWhence)
 {
-  __int64 nextPos = m_state->m_filePos;
+  __int64 nextPos = GetPosition();
 	switch(iWhence) 
 	{
 		case SEEK_SET:
@@ -732,12 +803,42 @@ __int64 CFileCurl::Seek(__int64 iFilePosition, int iWhence)
       return -1;
 	}
 
-  if(m_state->Seek(nextPos))
+  // the transfer is only moved once the reader gets past what's cached
+  if(m_cache && m_cache->GetCachedAhead(nextPos, 1))
+  {
+    m_cachePos = nextPos;
     return nextPos;
+  }
 
-  if(!m_seekable)
+  if(!SeekTransfer(nextPos))
     return -1;
 
+  m_cachePos = nextPos;
+  return m_state->m_filePos;
+}
+
+bool CFileCurl::SeekTransfer(__int64 pos)
+{
+  if(m_state->Seek(pos))
+    return true;
+
+  // the transfer we left for the last seek may be right where we want to be
+  if(m_parked && m_parked->Seek(pos))
+  {
+    CReadState* state = m_state;
+    m_state = m_parked;
+    m_parked = state;
+    return true;
+  }
+
+  return Reconnect(pos);
+}
+
+bool CFileCurl::Reconnect(__int64 pos)
+{
+  if(!m_seekable)
+    return false;
+
   CReadState* oldstate = NULL;
   if(!(m_url.Find(":31339") >= 0) && m_multisession)
   {
@@ -745,7 +846,7 @@ __int64 CFileCurl::Seek(__int64 iFilePosition, int iWhence)
     oldstate = m_state;
     m_state = new CReadState();
 
-    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), &m_state->m_easyHandle, &m_state->m_multiHandle );
+    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), url.GetPort(), &m_state->m_easyHandle, &m_state->m_multiHandle );
 
     // setup common curl options
     SetCommonOptions(m_state);
@@ -758,7 +859,7 @@ __int64 CFileCurl::Seek(__int64 iFilePosition, int iWhence)
   /* caller might have changed some headers (needed for daap)*/
   SetRequestHeaders(m_state);
 
-  m_state->m_filePos = nextPos;
+  m_state->m_filePos = pos;
   long response = m_state->Connect(m_bufferSize);
   if(response < 0)
   {
@@ -768,15 +869,343 @@ __int64 CFileCurl::Seek(__int64 iFilePosition, int iWhence)
       delete m_state;
       m_state = oldstate;
     }
-    return -1;
+    return false;
   }
 
   SetCorrectHeaders(m_state);
+  m_connects++;
 
   if(oldstate)
-    delete oldstate;
-  
-  return m_state->m_filePos;
+  {
+    // with a cache the reader usually comes back to where it was, after a look at the index
+    if(m_cache)
+    {
+      delete m_parked;
+      m_parked = oldstate;
+    }
+    else
+      delete oldstate;
+  }
+  return true;
+}
+
+bool CFileCurl::ReadString(char *szLine, int iLineLength)
+{
+  if(!m_cache)
+    return m_state->ReadString(szLine, iLineLength);
+
+  // lines are read from the transfer, wherever the reader is
+  if(m_state->m_filePos != m_cachePos && !SeekTransfer(m_cachePos))
+    return false;
+
+  bool result = m_state->ReadString(szLine, iLineLength);
+  m_cachePos = m_state->m_filePos;
+  return result;
+}
+
+unsigned int CFileCurl::Read(void* lpBuf, __int64 uiBufSize)
+{
+  if(!m_cache)
+    return m_state->Read(lpBuf, uiBufSize);
+
+  unsigned int size = (unsigned int)XMIN(uiBufSize, (__int64)INT_MAX);
+  unsigned int read = m_cache->Read(m_cachePos, (char*)lpBuf, size);
+
+  if(read == 0 && IsComing(m_cachePos))
+  {
+    // it's on its way over one of the extra connections
+    DWORD start = timeGetTime();
+    while(read == 0 && IsComing(m_cachePos) && !m_state->m_cancelled)
+    {
+      PumpSegments(true);
+      read = m_cache->Read(m_cachePos, (char*)lpBuf, size);
+    }
+    m_waitTime += timeGetTime() - start;
+  }
+
+  if(read == 0)
+  {
+    if(m_state->m_fileSize && m_cachePos >= m_state->m_fileSize)
+      return 0;
+
+    DWORD start = timeGetTime();
+    unsigned int connects = m_connects;
+    if(m_state->m_filePos != m_cachePos && !SeekTransfer(m_cachePos))
+      return 0;
+
+    read = m_state->Read(lpBuf, size);
+    if(read == 0 && connects == m_connects && !m_state->m_cancelled && m_cachePos < m_state->m_fileSize)
+    {
+      // the server may have given up on the transfer while nobody read from it
+      CLog::Log(LOGDEBUG, "FileCurl::Read(%p) idle transfer failed, reconnecting at %"PRId64, (void*)this, m_cachePos);
+      if(!Reconnect(m_cachePos))
+        return 0;
+
+      delete m_parked;
+      m_parked = NULL;
+      read = m_state->Read(lpBuf, size);
+    }
+    m_waitTime  += timeGetTime() - start;
+    m_recvBytes += read;
+
+    m_cache->Write(m_cachePos, (const char*)lpBuf, read);
+  }
+
+  m_cachePos  += read;
+  m_readBytes += read;
+  Prefetch();
+  return read;
+}
+
+void CFileCurl::Prefetch()
+{
+  DWORD now = timeGetTime();
+  DWORD elapsed = now - m_readTime;
+  if(elapsed >= 1000)
+  {
+    __int64 ahead = (__int64)m_readBytes * 1000 / elapsed * PREFETCH_SECONDS;
+    m_readAhead = (unsigned int)XMIN(ahead, (__int64)g_advancedSettings.m_curlcachesize * 1024 * 1024 / 2);
+    if(m_readAhead < m_bufferSize)
+      m_readAhead = m_bufferSize;
+
+    // when the reader spent a good part of the time waiting, see if another connection gets
+    // more through. if the last one made things worse, give it back.
+    if(m_segmented)
+    {
+      unsigned int rate = (unsigned int)((__int64)m_recvBytes * 1000 / elapsed);
+      if(m_waitTime * 10 > elapsed)
+      {
+        if(m_connections > 1 && rate < m_recvRate / 10 * 9)
+          m_connections--;
+        else if(m_connections < g_advancedSettings.m_curlconnections && (m_connections == 1 || rate > m_recvRate / 10 * 11))
+          m_connections++;
+      }
+      m_recvRate = rate;
+    }
+
+    m_readBytes = 0;
+    m_recvBytes = 0;
+    m_waitTime = 0;
+    m_readTime = now;
+  }
+
+  if(m_segmented)
+  {
+    PumpSegments(false);
+    ScheduleSegments();
+  }
+
+  // only if the transfer is at the end of what the reader has ahead of it
+  unsigned int ahead = m_cache->GetCachedAhead(m_cachePos, m_readAhead);
+  if(ahead >= m_readAhead || m_state->m_filePos != m_cachePos + ahead)
+    return;
+
+  // take what has arrived, so curl can go on receiving while the reader is busy with what it has
+  char buffer[16384];
+  while(ahead < m_readAhead)
+  {
+    unsigned int amount = m_state->ReadAvailable(buffer, XMIN((unsigned int)sizeof(buffer), m_readAhead - ahead));
+    if(amount == 0)
+      break;
+
+    m_cache->Write(m_state->m_filePos - amount, buffer, amount);
+    m_recvBytes += amount;
+    ahead += amount;
+  }
+}
+
+bool CFileCurl::IsComing(__int64 pos)
+{
+  for(unsigned int i = 0; i < m_segments.size(); i++)
+  {
+    if(m_segments[i].state->m_filePos <= pos && pos < m_segments[i].end)
+      return true;
+  }
+  return false;
+}
+
+void CFileCurl::ScheduleSegments()
+{
+  __int64 window = (__int64)g_advancedSettings.m_curlcachesize * 1024 * 1024 / 2;
+  __int64 limit  = XMIN(m_cachePos + window, m_state->m_fileSize);
+
+  // drop what the reader has passed, or won't get to after a seek
+  for(std::vector<CSegment>::iterator it = m_segments.begin(); it != m_segments.end();)
+  {
+    if(it->end <= m_cachePos || it->start >= limit)
+    {
+      delete it->state;
+      it = m_segments.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  if((int)m_segments.size() + 1 >= m_connections)
+    return;
+
+  // new parts go after what's cached, what the reader's transfer is about to bring and what's
+  // requested already. where they start after cached data they start on its last block, so
+  // they merge with whatever that block has. after a segment they start right at its end.
+  __int64 next = m_cachePos + m_cache->GetCachedAhead(m_cachePos, (unsigned int)window);
+  if(m_state->m_filePos == next)
+    next += m_segmentSize;
+  next = next / CBlockCache::BLOCK_SIZE * CBlockCache::BLOCK_SIZE;
+
+  CURL url(m_url);
+  DWORD now = timeGetTime();
+  while((int)m_segments.size() + 1 < m_connections)
+  {
+    // every pass either moves next forward or ends the loop
+    bool moved = true;
+    while(moved && next < limit)
+    {
+      moved = false;
+
+      unsigned int cached = m_cache->GetCachedAhead(next, (unsigned int)window);
+      if(cached >= CBlockCache::BLOCK_SIZE)
+      {
+        next = (next + cached) / CBlockCache::BLOCK_SIZE * CBlockCache::BLOCK_SIZE;
+        moved = true;
+      }
+
+      for(unsigned int i = 0; i < m_segments.size(); i++)
+      {
+        if(m_segments[i].start <= next && next < m_segments[i].end)
+        {
+          next = m_segments[i].end;
+          moved = true;
+        }
+      }
+    }
+    if(next >= limit)
+      break;
+
+    __int64 end = XMIN(next + m_segmentSize, m_state->m_fileSize);
+    for(unsigned int i = 0; i < m_segments.size(); i++)
+    {
+      if(m_segments[i].start > next && m_segments[i].start < end)
+        end = m_segments[i].start;
+    }
+
+    CSegment segment;
+    segment.state = new CReadState();
+    segment.start = next;
+    segment.end = end;
+    segment.requested = now;
+    segment.received = 0;
+
+    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), url.GetPort(), &segment.state->m_easyHandle, &segment.state->m_multiHandle);
+    SetCommonOptions(segment.state);
+    SetRequestHeaders(segment.state);
+    segment.state->m_filePos = next;
+    segment.state->Request(m_bufferSize, end);
+
+    m_segments.push_back(segment);
+    next = end;
+  }
+}
+
+void CFileCurl::PumpSegments(bool wait)
+{
+  if(wait)
+  {
+    fd_set fdread;
+    fd_set fdwrite;
+    fd_set fdexcep;
+    int maxfd = -1;
+
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+
+    // wait for any of them, they're all worth reading
+    for(unsigned int i = 0; i < m_segments.size(); i++)
+    {
+      int fd = -1;
+      if(CURLM_OK == g_curlInterface.multi_fdset(m_segments[i].state->m_multiHandle, &fdread, &fdwrite, &fdexcep, &fd) && fd > maxfd)
+        maxfd = fd;
+    }
+
+    if(maxfd >= 0)
+    {
+      struct timeval t = { 0, 100 * 1000 };
+      dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t);
+    }
+    else
+      SleepEx(10, true);
+  }
+
+  DWORD now = timeGetTime();
+  __int64 window = (__int64)g_advancedSettings.m_curlcachesize * 1024 * 1024 / 2;
+  char buffer[16384];
+  for(std::vector<CSegment>::iterator it = m_segments.begin(); it != m_segments.end();)
+  {
+    CReadState* state = it->state;
+    unsigned int amount;
+    while((amount = state->ReadAvailable(buffer, sizeof(buffer))) > 0)
+    {
+      if(!it->received)
+      {
+        // a server which doesn't do ranges sends the file from its start
+        long response = 0;
+        g_curlInterface.easy_getinfo(state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+        if(response != 206)
+        {
+          CLog::Log(LOGWARNING, "FileCurl::PumpSegments(%p) server answered a range with %ld, using one connection", (void*)this, response);
+          m_segmented = false;
+          break;
+        }
+
+        it->received = now;
+        m_connDelay = m_connDelay ? (m_connDelay * 3 + (now - it->requested)) / 4 : now - it->requested;
+      }
+
+      m_cache->Write(state->m_filePos - amount, buffer, amount);
+      m_recvBytes += amount;
+    }
+
+    if(!m_segmented)
+      break;
+
+    bool done = state->m_filePos >= it->end;
+    if(done && now > it->received)
+    {
+      unsigned int rate = (unsigned int)((it->end - it->start) * 1000 / (now - it->received));
+      m_connRate = m_connRate ? (m_connRate / 4 * 3 + rate / 4) : rate;
+
+      // a part should take long enough for the wait on its request not to matter, about ten
+      // times what a connection has in flight (the bandwidth-delay product)
+      __int64 size = (__int64)m_connRate * m_connDelay / 100;
+      size = XMIN(size, XMIN((__int64)SEGMENT_MAX, window / m_connections));
+      if(size < SEGMENT_MIN)
+        size = SEGMENT_MIN;
+      m_segmentSize = (unsigned int)(size / CBlockCache::BLOCK_SIZE * CBlockCache::BLOCK_SIZE);
+    }
+
+    if(done || (!state->m_stillRunning && state->m_buffer.GetMaxReadSize() == 0 && state->m_overflowSize == 0))
+    {
+      if(!done)
+      {
+        // likely more connections than the server lets us have
+        CLog::Log(LOGDEBUG, "FileCurl::PumpSegments(%p) transfer of %"PRId64"-%"PRId64" failed", (void*)this, it->start, it->end);
+        if(m_connections > 1)
+          m_connections--;
+      }
+      delete state;
+      it = m_segments.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  if(!m_segmented)
+  {
+    for(unsigned int i = 0; i < m_segments.size(); i++)
+      delete m_segments[i].state;
+    m_segments.clear();
+    m_connections = 1;
+  }
 }
 
 __int64 CFileCurl::GetLength()
@@ -788,7 +1217,7 @@ __int64 CFileCurl::GetLength()
 __int64 CFileCurl::GetPosition()
 {
 	if (!m_opened) return 0;
-	return m_state->m_filePos;
+	return m_cache ? m_cachePos : m_state->m_filePos;
 }
 
 int CFileCurl::Stat(const CURL& url, struct __stat64* buffer)
@@ -808,7 +1237,7 @@ int CFileCurl::Stat(const CURL& url, struct __stat64* buffer)
   url2.GetURL(m_url);
 
   ASSERT(m_state->m_easyHandle == NULL);
-  g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), &m_state->m_easyHandle, NULL);
+  g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), url2.GetPort(), &m_state->m_easyHandle, NULL);
 
   SetCommonOptions(m_state); 
   SetRequestHeaders(m_state);
@@ -904,6 +1333,39 @@ unsigned int CFileCurl::CReadState::Read(void* lpBuf, __int64 uiBufSize)
   return 0;
 }
 
+/* starts fetching m_filePos up to end, without waiting for an answer */
+void CFileCurl::CReadState::Request(unsigned int size, __int64 end)
+{
+  m_range.Format("%"PRId64"-%"PRId64, m_filePos, end - 1);
+  g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, m_range.c_str());
+  g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+
+  m_bufferSize = size;
+  m_buffer.Destroy();
+  m_buffer.Create(size * 3);
+  m_stillRunning = 1;
+}
+
+/* hands out what has arrived already, without waiting for more */
+unsigned int CFileCurl::CReadState::ReadAvailable(void* lpBuf, unsigned int uiBufSize)
+{
+  if(m_buffer.GetMaxReadSize() == 0)
+  {
+    if(m_overflowSize)
+      FillBuffer(1); /* doesn't wait, it's taken from the overflow buffer */
+    else if(m_stillRunning)
+      g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
+  }
+
+  unsigned int want = XMIN((unsigned int)m_buffer.GetMaxReadSize(), uiBufSize);
+  if(want && m_buffer.ReadBinary((char *)lpBuf, want))
+  {
+    m_filePos += want;
+    return want;
+  }
+  return 0;
+}
+
 /* use to attempt to fill the read buffer up to requested number of bytes */
 bool CFileCurl::CReadState::FillBuffer(unsigned int want)
 {  
@@ -1034,7 +1496,7 @@ void CFileCurl::SetRequestHeader(CStdString header, long value)
 {
   CStdString buffer;
   buffer.Format("%ld", value);
-  m_requestheaders[header] = buffer;
+  SetRequestHeader(header, buffer);
 }
 
 /* STATIC FUNCTIONS */
@@ -22,7 +22,9 @@
 
 #include "IFile.h"
 #include "RingBuffer.h"
+#include "BlockCache.h"
 #include <map>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -48,8 +50,8 @@ namespace XFILE
 	    virtual __int64	GetLength();
       virtual int	Stat(const CURL& url, struct __stat64* buffer);
 	    virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, __int64 uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual unsigned int Read(void* lpBuf, __int64 uiBufSize);
       virtual CStdString GetContent()                            { return m_state->m_httpheader.GetContentType(); }
             
       void Cancel();
@@ -67,6 +69,7 @@ namespace XFILE
       void SetBufferSize(unsigned int size);
       
       const CHttpHeader& GetHttpHeader() { return m_state->m_httpheader; }
+      long GetHttpResponseCode() const                           { return m_httpresponse; }
 
       /* static function that will get content type of a file */      
       static bool GetHttpHeader(const CURL &url, CHttpHeader &headers);
@@ -94,6 +97,8 @@ namespace XFILE
           bool            m_connected;
           
           CStdString      m_strDeadEndUrl; // If we can't redirect, this holds the last URL.
+          CStdString      m_range;         // curl keeps a pointer to it, while a range is requested
+          struct XCURL::curl_slist* m_headerList;  // and to this, so every transfer has its own copy
 
           /* returned http header */
           CHttpHeader m_httpheader;
@@ -104,9 +109,11 @@ namespace XFILE
           bool         Seek(__int64 pos);
           unsigned int Read(void* lpBuf, __int64 uiBufSize);
           bool         ReadString(char *szLine, int iLineLength);
+          unsigned int ReadAvailable(void* lpBuf, unsigned int uiBufSize);
           bool         FillBuffer(unsigned int want);
 
           long         Connect(unsigned int size);
+          void         Request(unsigned int size, __int64 end);
           void         Disconnect();
       };
 
@@ -115,11 +122,44 @@ namespace XFILE
       void SetCommonOptions(CReadState* state);
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
+      bool SeekTransfer(__int64 pos);
+      bool Reconnect(__int64 pos);
+      void Prefetch();
+      void ScheduleSegments();
+      void PumpSegments(bool wait);
+      bool IsComing(__int64 pos);
 
     private:
       CReadState*     m_state;
+      CReadState*     m_parked;           // the transfer we left for the last seek, to go back to
       unsigned int    m_bufferSize;
 
+      CBlockCache*    m_cache;            // what was read already, for seekable files
+      __int64         m_cachePos;         // where the reader is, m_state may be elsewhere
+      unsigned int    m_readAhead;        // how far the transfer should be ahead of the reader
+      unsigned int    m_readBytes;        // read since m_readTime, to tell the reader's rate
+      DWORD           m_readTime;
+      unsigned int    m_connects;         // counts the transfers started for the reader
+
+      // parts further ahead fetched over extra connections, when one can't keep up
+      struct CSegment
+      {
+        CReadState*   state;
+        __int64       start;
+        __int64       end;
+        DWORD         requested;
+        DWORD         received;           // when the first data came, 0 until then
+      };
+      std::vector<CSegment> m_segments;
+      bool            m_segmented;        // the server takes ranges and we may use more connections
+      int             m_connections;      // transfers allowed at once, the reader's included
+      unsigned int    m_segmentSize;
+      unsigned int    m_connRate;         // bytes per second a connection manages
+      unsigned int    m_connDelay;        // ms until a request gets its first data
+      unsigned int    m_recvBytes;        // received since m_readTime
+      unsigned int    m_recvRate;         // received per second before that
+      DWORD           m_waitTime;         // ms the reader waited for the network since m_readTime
+
       CStdString      m_url;
       CStdString      m_userAgent;
       CStdString      m_proxy;
@@ -134,6 +174,7 @@ namespace XFILE
       bool            m_seekable;
       bool            m_multisession;
       bool            m_binary;
+      long            m_httpresponse;
 
       CRingBuffer     m_buffer;           // our ringhold buffer
       char *          m_overflowBuffer;   // in the rare case we would overflow the above buffer
@@ -142,7 +183,6 @@ namespace XFILE
       int             m_stillRunning; /* Is background url fetch still in progress */
 
       struct XCURL::curl_slist* m_curlAliasList;
-      struct XCURL::curl_slist* m_curlHeaderList;
       
       typedef std::map<CStdString, CStdString> MAPHTTPHEADERS;
       MAPHTTPHEADERS m_requestheaders;
@@ -20,6 +20,7 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 #include "FileHD.h"
+#include "File.h"
 #include "Util.h"
 #include "URL.h"
 #include "GUISettings.h"
@@ -27,10 +28,17 @@
 #include <sys/stat.h>
 #ifdef _LINUX
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
 using namespace XFILE;
 
+// how many seconds of reading the os is asked to have read ahead of us
+#define READAHEAD_SECONDS 8
+#define READAHEAD_MIN     (1024 * 1024)
+#define READAHEAD_MAX     (64 * 1024 * 1024)
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -38,7 +46,15 @@ using namespace XFILE;
 //*********************************************************************************************
 CFileHD::CFileHD()
     : m_hFile(INVALID_HANDLE_VALUE)
-{}
+{
+  m_i64FilePos = 0;
+  m_i64Length = 0;
+  m_flags = 0;
+  m_i64AdviseEnd = 0;
+  m_i64RateBytes = 0;
+  m_rateTime = 0;
+  m_rate = 0;
+}
 
 //*********************************************************************************************
 CFileHD::~CFileHD()
@@ -82,6 +98,11 @@ bool CFileHD::Open(const CURL& url, bool bBinary)
   if (!m_hFile.isValid()) return false;
 
   m_i64FilePos = 0;
+  m_i64Length = GetLength();
+  m_i64AdviseEnd = 0;
+  m_i64RateBytes = 0;
+  m_rateTime = timeGetTime();
+  m_rate = 0;
   Seek(0, SEEK_SET);
 
   return true;
@@ -124,6 +145,7 @@ bool CFileHD::OpenForWrite(const CURL& url, bool bBinary, bool bOverWrite)
     return false;
 
   m_i64FilePos = 0;
+  m_i64Length = GetLength();
   Seek(0, SEEK_SET);
 
   return true;
@@ -133,15 +155,141 @@ bool CFileHD::OpenForWrite(const CURL& url, bool bBinary, bool bOverWrite)
 unsigned int CFileHD::Read(void *lpBuf, __int64 uiBufSize)
 {
   if (!m_hFile.isValid()) return 0;
+
+  if (!(m_flags & READ_ONCE))
+    ReadAhead();
+
+  // pages which were already cached may be someone else's, e.g. the player's read-ahead
+  // of the same file, so only those this read brings in are dropped again
+  std::vector<unsigned char> resident;
+  if (m_flags & READ_ONCE)
+    GetResidentPages(m_i64FilePos, uiBufSize, resident);
+
   DWORD nBytesRead;
   if ( ReadFile((HANDLE)m_hFile, lpBuf, (DWORD)uiBufSize, &nBytesRead, NULL) )
   {
+    if (m_flags & READ_ONCE)
+      DropPages(m_i64FilePos, nBytesRead, resident);
     m_i64FilePos += nBytesRead;
+    m_i64RateBytes += nBytesRead;
     return nBytesRead;
   }
   return 0;
 }
 
+//*********************************************************************************************
+void CFileHD::ReadAhead()
+{
+#ifdef _LINUX
+  DWORD now = timeGetTime();
+  if (now - m_rateTime >= 2000)
+  {
+    m_rate = (unsigned int)(m_i64RateBytes * 1000 / (now - m_rateTime));
+    m_i64RateBytes = 0;
+    m_rateTime = now;
+  }
+
+  // have the os read what we'll want in the next seconds while we're busy with the rest,
+  // asking for more once half of it is used
+  __int64 window = (__int64)m_rate * READAHEAD_SECONDS;
+  if (window < READAHEAD_MIN)
+    window = READAHEAD_MIN;
+  else if (window > READAHEAD_MAX)
+    window = READAHEAD_MAX;
+
+  if (m_i64FilePos + window / 2 < m_i64AdviseEnd)
+    return;
+
+  __int64 start = m_i64AdviseEnd > m_i64FilePos ? m_i64AdviseEnd : m_i64FilePos;
+  __int64 end   = m_i64FilePos + window < m_i64Length ? m_i64FilePos + window : m_i64Length;
+  if (end <= start)
+    return;
+
+#ifdef __APPLE__
+  struct radvisory advice;
+  advice.ra_offset = start;
+  advice.ra_count  = (int)(end - start);
+  fcntl((*m_hFile).fd, F_RDADVISE, &advice);
+#else
+  posix_fadvise((*m_hFile).fd, start, end - start, POSIX_FADV_WILLNEED);
+#endif
+  m_i64AdviseEnd = end;
+#endif
+}
+
+//*********************************************************************************************
+void CFileHD::GetResidentPages(__int64 start, __int64 size, std::vector<unsigned char>& resident)
+{
+  resident.clear();
+#if defined(_LINUX) && !defined(__APPLE__)
+  if (size <= 0)
+    return;
+
+  // mincore only looks at mappings, mapping the range doesn't read any of it
+  __int64 page  = sysconf(_SC_PAGESIZE);
+  __int64 first = start & ~(page - 1);
+  size_t  len   = (size_t)(start + size - first);
+  void* map = mmap(NULL, len, PROT_READ, MAP_SHARED, (*m_hFile).fd, first);
+  if (map == MAP_FAILED)
+    return;
+
+  resident.resize((len + page - 1) / page);
+  if (mincore(map, len, &resident[0]) != 0)
+    resident.clear();
+  munmap(map, len);
+#endif
+}
+
+//*********************************************************************************************
+void CFileHD::DropPages(__int64 start, __int64 size, const std::vector<unsigned char>& resident)
+{
+#if defined(_LINUX) && !defined(__APPLE__)
+  // without knowing what was cached before, it's safer to leave everything
+  if (size <= 0 || resident.empty())
+    return;
+
+  __int64 page  = sysconf(_SC_PAGESIZE);
+  __int64 first = start & ~(page - 1);
+  size_t  pages = (size_t)((start + size - first + page - 1) / page);
+  if (pages > resident.size())
+    pages = resident.size();
+
+  // drop each run of pages which weren't cached before the read
+  size_t i = 0;
+  while (i < pages)
+  {
+    if (resident[i] & 1)
+    {
+      i++;
+      continue;
+    }
+
+    size_t run = i;
+    while (i < pages && !(resident[i] & 1))
+      i++;
+    posix_fadvise((*m_hFile).fd, first + run * page, (i - run) * page, POSIX_FADV_DONTNEED);
+  }
+#endif
+}
+
+//*********************************************************************************************
+void CFileHD::SetReadHints(unsigned int flags)
+{
+  m_flags = flags;
+#ifdef _LINUX
+  if (!m_hFile.isValid())
+    return;
+
+#ifdef __APPLE__
+  // darwin can't drop pages once they're read, it reads around its cache instead
+  if (m_flags & READ_ONCE)
+    fcntl((*m_hFile).fd, F_NOCACHE, 1);
+#else
+  posix_fadvise((*m_hFile).fd, 0, 0, (m_flags & READ_ONCE) ? POSIX_FADV_RANDOM : POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+}
+
 //*********************************************************************************************
 int CFileHD::Write(const void *lpBuf, __int64 uiBufSize)
 {
@@ -168,7 +316,11 @@ __int64 CFileHD::Seek(__int64 iFilePosition, int iWhence)
   lPos.QuadPart = iFilePosition;
   int bSuccess;
 
-  __int64 length = GetLength();
+  // the length is only looked up again when a seek goes past it, files may still be growing
+  __int64 target = iWhence == SEEK_CUR ? GetPosition() + iFilePosition : iFilePosition;
+  if (iWhence == SEEK_END || target > m_i64Length)
+    m_i64Length = GetLength();
+  __int64 length = m_i64Length;
 
   switch (iWhence)
   {
@@ -195,6 +347,10 @@ __int64 CFileHD::Seek(__int64 iFilePosition, int iWhence)
   }
   if (bSuccess)
   {
+    // what was asked for ahead of the old position is no use after a jump
+    if (lNewPos.QuadPart < m_i64FilePos || lNewPos.QuadPart > m_i64AdviseEnd)
+      m_i64AdviseEnd = lNewPos.QuadPart;
+
     m_i64FilePos = lNewPos.QuadPart;
     return m_i64FilePos;
   }
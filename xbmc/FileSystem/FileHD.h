@@ -30,6 +30,7 @@
 #endif // _MSC_VER > 1000
 
 #include "IFile.h"
+#include <vector>
 
 namespace XFILE
 {
@@ -54,10 +55,20 @@ public:
   virtual bool Delete(const CURL& url);
   virtual bool Rename(const CURL& url, const CURL& urlnew);
   virtual int IoControl(int request, void* param);
+  virtual void SetReadHints(unsigned int flags);
 protected:
   CStdString GetLocal(const CURL &url); /* crate a properly format path from an url */
+  void ReadAhead();
+  void GetResidentPages(__int64 start, __int64 size, std::vector<unsigned char>& resident);
+  void DropPages(__int64 start, __int64 size, const std::vector<unsigned char>& resident);
   AUTOPTR::CAutoPtrHandle m_hFile;
   __int64 m_i64FilePos;
+  __int64 m_i64Length;      // as it was last looked up
+  unsigned int m_flags;
+  __int64 m_i64AdviseEnd;   // the os was asked to read ahead up to here
+  __int64 m_i64RateBytes;   // read since m_rateTime, to tell the rate the file is read at
+  DWORD m_rateTime;
+  unsigned int m_rate;
 };
 
 }
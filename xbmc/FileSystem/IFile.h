@@ -113,6 +113,9 @@ public:
   virtual ICacheInterface* GetCache() {return NULL;} 
   virtual int IoControl(int request, void* param) { return -1; }
 
+  /* how the file is going to be read, READ_* flags from File.h. most don't care */
+  virtual void SetReadHints(unsigned int flags) { }
+
   virtual CStdString GetContent()                            { return "application/octet-stream"; }
 };
 
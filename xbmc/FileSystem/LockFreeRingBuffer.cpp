@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "LockFreeRingBuffer.h"
+#include "cores/dvdplayer/AC3Encoder/pa_memorybarrier.h"
+
+CLockFreeRingBuffer::CLockFreeRingBuffer()
+{
+  m_buffer   = NULL;
+  m_size     = 0;
+  m_capacity = 0;
+  m_history  = 0;
+  m_write    = 0;
+  m_read     = 0;
+  m_behind   = 0;
+}
+
+CLockFreeRingBuffer::~CLockFreeRingBuffer()
+{
+  Destroy();
+}
+
+bool CLockFreeRingBuffer::Create(unsigned int size, unsigned int history)
+{
+  Destroy();
+
+  if (size == 0 || history >= size)
+    return false;
+
+  m_size = 1;
+  while (m_size < size)
+    m_size <<= 1;
+
+  m_buffer = new char[m_size];
+  if (!m_buffer)
+  {
+    m_size = 0;
+    return false;
+  }
+
+  m_capacity = size;
+  m_history  = history;
+  Clear();
+  return true;
+}
+
+void CLockFreeRingBuffer::Destroy()
+{
+  delete[] m_buffer;
+  m_buffer   = NULL;
+  m_size     = 0;
+  m_capacity = 0;
+  m_history  = 0;
+  Clear();
+}
+
+void CLockFreeRingBuffer::Clear()
+{
+  m_write  = 0;
+  m_read   = 0;
+  m_behind = 0;
+  PaUtil_FullMemoryBarrier();
+}
+
+unsigned int CLockFreeRingBuffer::GetMaxReadSize() const
+{
+  return m_write - m_read;
+}
+
+unsigned int CLockFreeRingBuffer::GetMaxWriteSize() const
+{
+  // after a rewind the reader may be further behind than the history allows for
+  int free = (int)(m_capacity - m_history) - (int)(m_write - m_read);
+  return free > 0 ? free : 0;
+}
+
+char* CLockFreeRingBuffer::ReserveWrite(unsigned int& size)
+{
+  size = GetMaxWriteSize();
+
+  // the space has to be read free before we write into it
+  PaUtil_FullMemoryBarrier();
+
+  unsigned int offset = m_write & (m_size - 1);
+  if (size > m_size - offset)
+    size = m_size - offset;
+  return m_buffer + offset;
+}
+
+void CLockFreeRingBuffer::CommitWrite(unsigned int size)
+{
+  PaUtil_WriteMemoryBarrier();
+  m_write = m_write + size;
+}
+
+unsigned int CLockFreeRingBuffer::Write(const char* buffer, unsigned int size)
+{
+  unsigned int done = 0;
+  while (done < size)
+  {
+    unsigned int amount;
+    char* dest = ReserveWrite(amount);
+    if (amount == 0)
+      break;
+    if (amount > size - done)
+      amount = size - done;
+
+    memcpy(dest, buffer + done, amount);
+    CommitWrite(amount);
+    done += amount;
+  }
+  return done;
+}
+
+const char* CLockFreeRingBuffer::PeekRead(unsigned int& size)
+{
+  size = m_write - m_read;
+  PaUtil_ReadMemoryBarrier();
+
+  unsigned int offset = m_read & (m_size - 1);
+  if (size > m_size - offset)
+    size = m_size - offset;
+  return m_buffer + offset;
+}
+
+void CLockFreeRingBuffer::CommitRead(unsigned int size)
+{
+  // we must be done with the data before the producer may see its space
+  PaUtil_FullMemoryBarrier();
+  m_read = m_read + size;
+
+  m_behind += size;
+  if (m_behind > m_history)
+    m_behind = m_history;
+}
+
+unsigned int CLockFreeRingBuffer::Read(char* buffer, unsigned int size)
+{
+  unsigned int done = 0;
+  while (done < size)
+  {
+    unsigned int amount;
+    const char* src = PeekRead(amount);
+    if (amount == 0)
+      break;
+    if (amount > size - done)
+      amount = size - done;
+
+    memcpy(buffer + done, src, amount);
+    CommitRead(amount);
+    done += amount;
+  }
+  return done;
+}
+
+bool CLockFreeRingBuffer::Rewind(unsigned int size)
+{
+  // the producer never writes more than the capacity less the history ahead of the
+  // furthest point we've read to, so whatever we count as history is still there.
+  if (size > m_behind)
+    return false;
+
+  m_read   = m_read - size;
+  m_behind -= size;
+  return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// A byte ring for exactly one thread writing and one thread reading, without locks.
+// Both sides can work on the ring's memory in place: ReserveWrite/CommitWrite hand the
+// producer the free space to fill, PeekRead/CommitRead hand the consumer the data.
+// A history of the last bytes read can be kept, which the consumer can rewind into.
+//
+// Create, Destroy and Clear may only be called while neither side uses the ring.
+class CLockFreeRingBuffer
+{
+public:
+  CLockFreeRingBuffer();
+  ~CLockFreeRingBuffer();
+
+  // size includes the history which is kept behind the reader
+  bool Create(unsigned int size, unsigned int history = 0);
+  void Destroy();
+  void Clear();
+
+  unsigned int Size() const { return m_capacity; }
+
+  // these two can be asked from either thread
+  unsigned int GetMaxReadSize() const;
+  unsigned int GetMaxWriteSize() const;
+
+  // producer side. ReserveWrite returns the free space from the write position up to the
+  // end of the ring, its length in size.
+  char* ReserveWrite(unsigned int& size);
+  void CommitWrite(unsigned int size);
+  unsigned int Write(const char* buffer, unsigned int size);
+
+  // consumer side. PeekRead returns the data from the read position up to the end of the
+  // ring, its length in size.
+  const char* PeekRead(unsigned int& size);
+  void CommitRead(unsigned int size);
+  unsigned int Read(char* buffer, unsigned int size);
+
+  // how far the consumer can rewind, and rewinding
+  unsigned int GetHistorySize() const { return m_behind; }
+  bool Rewind(unsigned int size);
+
+private:
+  enum { CACHE_LINE = 64 };
+
+  char*        m_buffer;
+  unsigned int m_size;      // a power of two, so the positions can wrap around freely
+  unsigned int m_capacity;  // what may be used of it
+  unsigned int m_history;
+
+  // the positions only ever grow and are taken modulo the size. each lives on its own
+  // cache line, so the two threads don't keep taking the line away from each other.
+  char m_pad0[CACHE_LINE];
+  volatile unsigned int m_write;  // only moved by the producer
+  char m_pad1[CACHE_LINE - sizeof(unsigned int)];
+  volatile unsigned int m_read;   // only moved by the consumer
+  unsigned int m_behind;          // valid bytes before m_read, consumer only
+  char m_pad2[CACHE_LINE - 2 * sizeof(unsigned int)];
+};
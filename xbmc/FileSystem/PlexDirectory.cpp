@@ -14,6 +14,7 @@
 #include "CocoaUtils.h"
 #include "File.h"
 #include "PlexDirectory.h"
+#include "PlexDirectoryCache.h"
 #include "DirectoryCache.h"
 #include "Util.h"
 #include "FileCurl.h"
@@ -27,6 +28,7 @@
 #include "GUIViewState.h"
 #include "GUIDialogOK.h"
 #include "Picture.h"
+#include "PlexImageCache.h"
 
 using namespace std;
 using namespace XFILE;
@@ -42,6 +44,18 @@ CPlexDirectory::CPlexDirectory(bool parseResults, bool displayDialog)
   , m_bSuccess(true)
   , m_bParseResults(parseResults)
   , m_dirCacheType(DIR_CACHE_ALWAYS)
+  , m_containerStart(0)
+  , m_containerSize(0)
+  , m_cachedCacheType(DIR_CACHE_ALWAYS)
+  , m_bNotModified(false)
+  , m_items(0)
+  , m_doc(0)
+  , m_mediaNode(0)
+  , m_scanPos(0)
+  , m_elementStart(0)
+  , m_depth(0)
+  , m_rootClosed(false)
+  , m_gotType(false)
 {
   m_timeout = 300;
   
@@ -52,6 +66,7 @@ CPlexDirectory::CPlexDirectory(bool parseResults, bool displayDialog)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 CPlexDirectory::~CPlexDirectory()
 {
+  EndParse();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -66,12 +81,45 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
   // Start the download thread running.
   printf("PlexDirectory::GetDirectory(%s)\n", strRoot.c_str());
   m_url = strRoot;
+  
+  // Windows which can fill in the listing as the user scrolls ask for it to be paged.
+  bool paged = false;
+  if (m_containerSize == 0 && items.GetPropertyBOOL("pagedListing") && g_advancedSettings.m_iPlexPageSize > 0)
+  {
+    SetContainerRange(0, g_advancedSettings.m_iPlexPageSize);
+    paged = true;
+  }
+  
+  // Items before ours (e.g. the parent folder item) offset the container indexes.
+  int containerOffset = items.Size();
+  
+  // If we've seen this listing before, we'll ask the server whether it changed.
+  m_cacheKey = m_url;
+  if (m_containerSize > 0)
+  {
+    CStdString range;
+    range.Format("#%d-%d", m_containerStart, m_containerSize);
+    m_cacheKey += range;
+  }
+  
+  m_bNotModified = false;
+  m_cachedItems.reset();
+  if (m_bParseResults)
+    g_plexDirectoryCache.GetListing(m_cacheKey, m_etag, m_lastModified, m_cachedItems, m_cachedCacheType);
+  
+  // Items are built by the download thread as the response streams in.
+  if (m_bParseResults)
+    BeginParse(&items);
+  
   CThread::Create(false, 0);
 
-  // Now display progress, look for cancel.
+  // Now display progress, look for cancel. The caller only gets the listing once the whole
+  // response is in, parsing as it arrives just saves holding the body and a DOM of all of it.
+  // Media windows see the first screen early because they ask for the listing a page at a time.
   CGUIDialogProgress* dlgProgress = 0;
   
   int time = GetTickCount();
+  bool cancelled = false;
   
   while (m_downloadEvent.WaitMSec(100) == false)
   {
@@ -96,6 +144,7 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
       if (dlgProgress->IsCanceled())
       {
         items.m_wasListingCancelled = true;
+        cancelled = true;
         m_http.Cancel();
         StopThread();
       }
@@ -108,22 +157,57 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
   // Wait for the thread to exit.
   WaitForThreadExit(INFINITE);
 
-  // See if we suceeded.
-  if (m_bSuccess == false)
+  // See if we suceeded. Items parsed before it went wrong mustn't be left behind, the
+  // caller would show a listing which was cut short.
+  if (m_bSuccess == false || cancelled)
+  {
+    RemoveParsedItems(items, containerOffset);
     return false;
+  }
   
   // See if we're supposed to parse the results or not.
   if (m_bParseResults == false)
     return true;
   
-  // Parse returned xml.
-  TiXmlDocument doc;
-  doc.Parse(m_data.c_str());
-
-  TiXmlElement* root = doc.RootElement();
-  if (root == 0)
+  // Our copy is still current, so there's nothing to parse.
+  if (m_bNotModified)
   {
-    CLog::Log(LOGERROR, "%s - Unable to parse XML\n%s", __FUNCTION__, m_data.c_str());
+    items.Assign(*m_cachedItems, true);
+    m_dirCacheType = m_cachedCacheType;
+    
+    // Do what the root element did when the listing was parsed: its fanart, which Assign
+    // doesn't carry over, and its view mode.
+    CStdString strFanart = m_cachedItems->GetQuickFanart();
+    if (strFanart.size() > 0)
+    {
+      CPlexImageCache::Get()->Expire(CFileItem::GetCachedPlexMediaServerThumb(strFanart), MAX_FANART_AGE);
+      items.SetQuickFanart(strFanart);
+    }
+    
+    if (items.GetDefaultViewMode() > 0)
+    {
+      CGUIViewState* viewState = CGUIViewState::GetViewState(0, items);
+      viewState->SaveViewAsControl(items.GetDefaultViewMode());
+    }
+    
+    // Placeholder indexes are relative to whatever came before the container.
+    if (items.HasProperty("containerOffset"))
+    {
+      items.SetProperty("containerOffset", containerOffset);
+      
+      // Only windows which fill in placeholders may see this listing, see below.
+      m_dirCacheType = DIR_CACHE_NEVER;
+    }
+    
+    return true;
+  }
+  
+  // The children have already been parsed, all that's left is the root.
+  TiXmlElement* root = m_doc ? m_doc->RootElement() : 0;
+  if (root == 0 || m_rootClosed == false)
+  {
+    CLog::Log(LOGERROR, "%s - Unable to parse XML from %s", __FUNCTION__, m_url.c_str());
+    RemoveParsedItems(items, containerOffset);
     return false;
   }
   
@@ -140,9 +224,7 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
     strThumb = ProcessUrl(strPath, thumb, false);
 
   // See if the item is too old.
-  string cachedFile(CFileItem::GetCachedPlexMediaServerThumb(strFanart));
-  if (CFile::Age(cachedFile) > MAX_FANART_AGE)
-    CFile::Delete(cachedFile);
+  CPlexImageCache::Get()->Expire(CFileItem::GetCachedPlexMediaServerThumb(strFanart), MAX_FANART_AGE);
   
   // Walk the parsed tree.
   string strFileLabel = "%N - %T"; 
@@ -150,7 +232,7 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
   string strDirLabel = "%B";
   string strSecondDirLabel = "%Y";
   
-  Parse(m_url, root, items, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
+  ComputeLabels(strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
   
   // Check if any restrictions should be applied
   bool disableFanart = false;
@@ -212,7 +294,7 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
     if (strFanart.size() > 0)
     {
       // Only do this if we have it cached already.
-      if (CFile::Exists(CFileItem::GetCachedPlexMediaServerFanart(strFanart)))
+      if (CPlexImageCache::Get()->Exists(CFileItem::GetCachedPlexMediaServerFanart(strFanart)))
         pItem->SetProperty("fanart_image_fallback", CFileItem::GetCachedPlexMediaServerFanart(strFanart));
     }
     
@@ -346,6 +428,37 @@ bool CPlexDirectory::GetDirectory(const CStdString& strPath, CFileItemList &item
     m_dirCacheType = DIR_CACHE_NEVER;
   }
   
+  // If we only got the first page, stand in placeholders for the rest of the container.
+  const char* totalSize = root->Attribute("totalSize");
+  if (paged && totalSize && strlen(totalSize) > 0)
+  {
+    int total = boost::lexical_cast<int>(totalSize);
+    int have = items.Size() - containerOffset;
+    
+    if (total > have)
+    {
+      items.SetProperty("containerOffset", containerOffset);
+      items.SetProperty("containerSize", total);
+      
+      items.Reserve(containerOffset + total);
+      for (int i=have; i<total; i++)
+        items.Add(CreatePlaceholder(i));
+    }
+  }
+  
+  // Remember it, so next time a 304 can stand in for the whole download. Listings
+  // that asked not to be cached are left alone, unless they're only uncached
+  // because they refresh themselves, which is exactly where revalidating pays.
+  //
+  bool cacheable = (m_dirCacheType != DIR_CACHE_NEVER || items.m_autoRefresh > 0);
+  if (cacheable && items.m_displayMessage == false)
+    g_plexDirectoryCache.SetListing(m_cacheKey, m_etag, m_lastModified, items, containerOffset, m_dirCacheType);
+  
+  // A first page padded with placeholders mustn't go into the directory cache under the
+  // plain path, where anything else listing the folder would get the empty items.
+  if (items.HasProperty("containerOffset"))
+    m_dirCacheType = DIR_CACHE_NEVER;
+  
   return true;
 }
 
@@ -558,9 +671,7 @@ class PlexMediaNode
        string strMedia = CPlexDirectory::ProcessUrl(parentPath, media, false);
        
        // See if the item is too old.
-       string cachedFile(CFileItem::GetCachedPlexMediaServerThumb(strMedia));
-       if (CFile::Age(cachedFile) > maxAge)
-         CFile::Delete(cachedFile);
+       CPlexImageCache::Get()->Expire(CFileItem::GetCachedPlexMediaServerThumb(strMedia), maxAge);
        
        return strMedia;
      }
@@ -590,7 +701,7 @@ class PlexMediaNode
 
        // See if it exists (fasttrack) or queue it for download.
        string localFile = CFileItem::GetCachedPlexMediaServerThumb(url);
-       if (CFile::Exists(localFile))
+       if (CPlexImageCache::Get()->Exists(localFile))
          mediaItem->SetProperty("mediaTag::" + attr, localFile);
        else
          mediaItem->SetProperty("cache$mediaTag::" + attr, url);
@@ -1351,65 +1462,65 @@ PlexMediaNode* PlexMediaNode::Create(TiXmlElement* element)
 }
   
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void CPlexDirectory::Parse(const CURL& url, TiXmlElement* root, CFileItemList &items, string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel)
+void CPlexDirectory::ParseElement(const CURL& url, TiXmlElement* element, CFileItemList &items)
 {
-  PlexMediaNode* mediaNode = 0;
+  PlexMediaNode* mediaNode = PlexMediaNode::Create(element);
+  if (mediaNode == 0)
+    return;
+  
+  // The last node decides the labels for the whole container.
+  delete m_mediaNode;
+  m_mediaNode = mediaNode;
+  
+  CFileItemPtr item = mediaNode->BuildFileItem(url, *element);
+  if (!item)
+    return;
   
-  bool gotType = false;
-  for (TiXmlElement* element = root->FirstChildElement(); element; element=element->NextSiblingElement())
+  items.Add(item);
+
+  // Get the type.
+  const char* pType = element->Attribute("type");
+  if (pType)
   {
-    mediaNode = PlexMediaNode::Create(element);
-    if (mediaNode != 0)
+    string type = pType;
+    if (type == "show")
+      type = "tvshows";
+    else if (type == "season")
+      type = "seasons";
+    else if (type == "episode")
+      type = "episodes";
+    else if (type == "movie")
+      type = "movies";
+    else if (type == "artist")
+      type = "artists";
+    else if (type == "album")
+      type = "albums";
+    else if (type == "track")
+      type = "songs";
+
+    // Set the content type for the collection.
+    if (m_gotType == false)
     {
-      CFileItemPtr item = mediaNode->BuildFileItem(url, *element);
-      if (item)
-        items.Add(item);
-    
-      // Get the type.
-      const char* pType = element->Attribute("type");
-      if (pType)
-      {
-        string type = pType;
-        if (type == "show")
-          type = "tvshows";
-        else if (type == "season")
-          type = "seasons";
-        else if (type == "episode")
-          type = "episodes";
-        else if (type == "movie")
-          type = "movies";
-        else if (type == "artist")
-          type = "artists";
-        else if (type == "album")
-          type = "albums";
-        else if (type == "track")
-          type = "songs";
-
-        // Set the content type for the collection.
-        if (gotType == false)
-        {
-          items.SetContent(type);
-          gotType = true;
-        }
-        
-        // Set the content type for the item.
-        item->SetProperty("mediaType", type);
-      }
-      
-      // Tags.
-      ParseTags(element, item, "Genre");
-      ParseTags(element, item, "Writer");
-      ParseTags(element, item, "Director");
-      ParseTags(element, item, "Role");
+      items.SetContent(type);
+      m_gotType = true;
     }
+    
+    // Set the content type for the item.
+    item->SetProperty("mediaType", type);
   }
   
-  if (mediaNode != 0)
-  {
-    CStdString strURL;
-    url.GetURL(strURL);
-    mediaNode->ComputeLabels(strURL, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
-  }
+  // Tags.
+  ParseTags(element, item, "Genre");
+  ParseTags(element, item, "Writer");
+  ParseTags(element, item, "Director");
+  ParseTags(element, item, "Role");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::ComputeLabels(string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel)
+{
+  if (m_mediaNode != 0)
+    m_mediaNode->ComputeLabels(m_url, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1449,11 +1560,28 @@ void CPlexDirectory::Process()
   url.SetPort(32400);  
 
   // Set request headers.
+  m_http.ClearRequestHeaders();
   m_http.SetRequestHeader("X-Plex-Version", Cocoa_GetAppVersion());
   m_http.SetRequestHeader("X-Plex-Language", Cocoa_GetLanguage());
   m_http.SetRequestHeader("X-Plex-Client-Platform", "MacOSX");
   m_http.SetRequestHeader("X-Plex-Client-Capabilities", "protocols=shoutcast,webkit,http-video,spiff");
   
+  // Revalidate the listing we already have rather than downloading it again.
+  if (m_cachedItems)
+  {
+    if (m_etag.size() > 0)
+      m_http.SetRequestHeader("If-None-Match", m_etag);
+    if (m_lastModified.size() > 0)
+      m_http.SetRequestHeader("If-Modified-Since", m_lastModified);
+  }
+  
+  // Ask for a range of the container if we're paging.
+  if (m_containerSize > 0)
+  {
+    m_http.SetRequestHeader("X-Plex-Container-Start", m_containerStart);
+    m_http.SetRequestHeader("X-Plex-Container-Size", m_containerSize);
+  }
+  
   m_http.SetTimeout(m_timeout);
   if (m_http.Open(url, false) == false) 
   {
@@ -1465,6 +1593,19 @@ void CPlexDirectory::Process()
 
   // Restore protocol.
   url.SetProtocol(protocol);
+  
+  if (m_cachedItems && m_http.GetHttpResponseCode() == 304)
+  {
+    m_bNotModified = true;
+    m_http.Close();
+    m_downloadEvent.Set();
+    return;
+  }
+  
+  // Keep the validators for the new copy.
+  CHttpHeader header = m_http.GetHttpHeader();
+  m_etag = header.GetValue("ETag");
+  m_lastModified = header.GetValue("Last-Modified");
 
   CStdString content = m_http.GetContent();
   if (content.Equals("text/xml;charset=utf-8") == false && content.Equals("application/xml") == false)
@@ -1479,20 +1620,31 @@ void CPlexDirectory::Process()
     int size_total = (int)m_http.GetLength();
     int data_size = 0;
   
-    m_data.reserve(size_total);
-    //printf("Content-Length was %d bytes\n", size_total);
+    if (m_bParseResults == false)
+      m_data.reserve(size_total);
     
-    // Read response from server into string buffer.
+    // Read the response from the server, handing each chunk straight to the
+    // parser so that items are built while the rest is still downloading.
+    //
     char buffer[4096];
-    while (m_bStop == false && (size_read = m_http.Read(buffer, sizeof(buffer)-1)) > 0)
+    while (m_bStop == false && (size_read = m_http.Read(buffer, sizeof(buffer))) > 0)
     {
-      buffer[size_read] = 0;
-      m_data += buffer;
       data_size += size_read;
+      
+      if (m_bParseResults == false)
+      {
+        m_data.append(buffer, size_read);
+      }
+      else if (ScanData(buffer, size_read) == false)
+      {
+        CLog::Log(LOGERROR, "%s - Unable to parse XML from %s", __FUNCTION__, m_url.c_str());
+        m_bSuccess = false;
+        break;
+      }
     }
     
     // If we didn't get it all, we failed.
-    if (m_data.size() != size_total)
+    if (data_size != size_total)
       m_bSuccess = false;
   }
 
@@ -1500,6 +1652,227 @@ void CPlexDirectory::Process()
   m_downloadEvent.Set();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::RemoveParsedItems(CFileItemList& items, int offset)
+{
+  // Everything after the items the caller passed in came from us.
+  while (items.Size() > offset)
+    items.Remove(items.Size() - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::BeginParse(CFileItemList* items)
+{
+  EndParse();
+  
+  m_items = items;
+  m_doc = new TiXmlDocument();
+  m_pending.clear();
+  m_scanPos = 0;
+  m_elementStart = 0;
+  m_depth = 0;
+  m_rootClosed = false;
+  m_gotType = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::EndParse()
+{
+  delete m_mediaNode;
+  m_mediaNode = 0;
+  
+  delete m_doc;
+  m_doc = 0;
+  
+  m_items = 0;
+  m_pending.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static size_t FindTagEnd(const string& data, size_t pos)
+{
+  // Find the closing '>', skipping any that appear inside quoted attribute values.
+  char quote = 0;
+  for (size_t i=pos; i<data.size(); i++)
+  {
+    char c = data[i];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '>')
+      return i;
+  }
+  
+  return string::npos;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::ScanData(const char* data, int size)
+{
+  m_pending.append(data, size);
+  
+  // Walk the markup just far enough to find where each top-level child of the
+  // container ends; the children themselves are handed to TinyXML one by one.
+  //
+  while (m_rootClosed == false)
+  {
+    size_t start = m_pending.find('<', m_scanPos);
+    if (start == string::npos)
+    {
+      m_scanPos = m_pending.size();
+      break;
+    }
+    
+    // Need at least a few characters to tell what kind of markup this is.
+    if (m_pending.size() - start < 4)
+    {
+      m_scanPos = start;
+      break;
+    }
+    
+    size_t end = string::npos;
+    if (m_pending.compare(start, 4, "<!--") == 0)
+    {
+      end = m_pending.find("-->", start+4);
+      if (end != string::npos)
+        end += 2;
+    }
+    else if (m_pending.compare(start, 2, "<?") == 0)
+    {
+      end = m_pending.find("?>", start+2);
+      if (end != string::npos)
+        end += 1;
+    }
+    else if (m_pending.compare(start, 2, "<!") == 0)
+    {
+      // CDATA sections need at least the full opener before we can tell.
+      if (m_pending.size() - start < 9)
+      {
+        m_scanPos = start;
+        break;
+      }
+      
+      if (m_pending.compare(start, 9, "<![CDATA[") == 0)
+      {
+        end = m_pending.find("]]>", start+9);
+        if (end != string::npos)
+          end += 2;
+      }
+      else
+      {
+        end = m_pending.find('>', start+2);
+      }
+    }
+    else if (m_pending[start+1] == '/')
+    {
+      end = m_pending.find('>', start+2);
+      if (end != string::npos)
+      {
+        m_depth--;
+        if (m_depth == 1)
+        {
+          if (ParseChildElement(m_pending.substr(m_elementStart, end+1-m_elementStart)) == false)
+            return false;
+        }
+        else if (m_depth == 0)
+        {
+          m_rootClosed = true;
+        }
+      }
+    }
+    else
+    {
+      end = FindTagEnd(m_pending, start+1);
+      if (end != string::npos)
+      {
+        bool selfClosing = (m_pending[end-1] == '/');
+        
+        if (m_depth == 0)
+        {
+          if (ParseRootElement(m_pending.substr(start, end+1-start)) == false)
+            return false;
+          
+          if (selfClosing)
+            m_rootClosed = true;
+        }
+        else if (m_depth == 1)
+        {
+          m_elementStart = start;
+          if (selfClosing && ParseChildElement(m_pending.substr(start, end+1-start)) == false)
+            return false;
+        }
+        
+        if (selfClosing == false)
+          m_depth++;
+      }
+    }
+    
+    // Wait for more data if the markup isn't complete yet.
+    if (end == string::npos)
+    {
+      m_scanPos = start;
+      break;
+    }
+    
+    m_scanPos = end+1;
+  }
+  
+  // Throw away whatever is no longer needed, keeping only the child in flight.
+  size_t keepFrom = (m_depth > 1) ? m_elementStart : m_scanPos;
+  if (keepFrom > 0)
+  {
+    m_pending.erase(0, keepFrom);
+    m_scanPos -= keepFrom;
+    if (m_depth > 1)
+      m_elementStart = 0;
+  }
+  
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::ParseRootElement(const string& tag)
+{
+  // Parse the opening tag on its own, which gives us an element with just the attributes.
+  string xml = tag;
+  if (xml[xml.size()-2] != '/')
+    xml.insert(xml.size()-1, "/");
+  
+  m_doc->Parse(xml.c_str(), 0, TIXML_ENCODING_UTF8);
+  return m_doc->RootElement() != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::ParseChildElement(const string& xml)
+{
+  TiXmlElement* root = m_doc->RootElement();
+  
+  // Hang the child off the root, since the nodes look at the parent's attributes.
+  TiXmlElement* element = new TiXmlElement("");
+  root->LinkEndChild(element);
+  
+  bool ret = (element->Parse(xml.c_str(), 0, TIXML_ENCODING_UTF8) != 0);
+  if (ret)
+  {
+    try
+    {
+      ParseElement(CURL(m_url), element, *m_items);
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - Exception building item from %s", __FUNCTION__, m_url.c_str());
+    }
+  }
+  
+  // Done with it.
+  root->RemoveChild(element);
+  return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void CPlexDirectory::OnExit()
 {
@@ -1513,6 +1886,29 @@ void CPlexDirectory::StopThread()
   CThread::StopThread();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CFileItemPtr CPlexDirectory::CreatePlaceholder(int index)
+{
+  // An empty item holding the slot for a container item which hasn't been fetched yet.
+  CFileItemPtr pItem(new CFileItem());
+  pItem->SetLabelPreformated(true);
+  pItem->SetProperty("placeholderIndex", index);
+  
+  return pItem;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::IsPlaceholder(const CFileItem* item)
+{
+  return item && item->HasProperty("placeholderIndex");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+int CPlexDirectory::GetPlaceholderIndex(const CFileItemPtr& item)
+{
+  return item->GetPropertyInt("placeholderIndex");
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 string CPlexDirectory::ProcessUrl(const string& parent, const string& url, bool isDirectory)
 {
@@ -10,10 +10,13 @@
 
 #include "FileCurl.h"
 #include "IDirectory.h"
+#include "PlexDirectoryCache.h"
 #include "Thread.h"
 
 class CURL;
 class TiXmlElement;
+class TiXmlDocument;
+class PlexMediaNode;
 using namespace std;
 using namespace XFILE;
 
@@ -31,6 +34,14 @@ class CPlexDirectory : public IDirectory,
   static string ProcessUrl(const string& parent, const string& url, bool isDirectory);
   virtual void SetTimeout(int timeout) { m_timeout = timeout; }
   
+  // Only fetch part of the container, size of zero means everything.
+  void SetContainerRange(int start, int size) { m_containerStart = start; m_containerSize = size; }
+  
+  static CFileItemPtr CreatePlaceholder(int index);
+  static bool IsPlaceholder(const CFileItem* item);
+  static bool IsPlaceholder(const CFileItemPtr& item) { return IsPlaceholder(item.get()); }
+  static int GetPlaceholderIndex(const CFileItemPtr& item);
+  
   string GetData() { return m_data; } 
   
  protected:
@@ -39,9 +50,18 @@ class CPlexDirectory : public IDirectory,
   virtual void OnExit();
   virtual void StopThread();
   
-  void Parse(const CURL& url, TiXmlElement* root, CFileItemList &items, string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel);
+  void ParseElement(const CURL& url, TiXmlElement* element, CFileItemList &items);
+  void ComputeLabels(string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel);
   void ParseTags(TiXmlElement* element, const CFileItemPtr& item, const string& name);
   
+  // Incremental parsing of the response as it arrives from the server.
+  void BeginParse(CFileItemList* items);
+  bool ScanData(const char* data, int size);
+  bool ParseRootElement(const string& tag);
+  bool ParseChildElement(const string& xml);
+  void EndParse();
+  void RemoveParsedItems(CFileItemList& items, int offset);
+  
   CEvent     m_downloadEvent;
   bool       m_bStop;
   
@@ -52,6 +72,29 @@ class CPlexDirectory : public IDirectory,
   int        m_timeout;
   CFileCurl  m_http;
   DIR_CACHE_TYPE m_dirCacheType;
+  int        m_containerStart;
+  int        m_containerSize;
+  
+  // Conditional GET state. The cached listing (if any) is revalidated with the
+  // server and used as-is when it answers 304.
+  CStdString       m_cacheKey;
+  CFileItemListPtr m_cachedItems;
+  DIR_CACHE_TYPE   m_cachedCacheType;
+  CStdString       m_etag;
+  CStdString       m_lastModified;
+  bool             m_bNotModified;
+  
+  // Streaming parser state. Only the root element (attributes only) and the
+  // top-level child currently being received are ever held in memory.
+  CFileItemList* m_items;
+  TiXmlDocument* m_doc;
+  PlexMediaNode* m_mediaNode;
+  string         m_pending;
+  size_t         m_scanPos;
+  size_t         m_elementStart;
+  int            m_depth;
+  bool           m_rootClosed;
+  bool           m_gotType;
 };
 
 }
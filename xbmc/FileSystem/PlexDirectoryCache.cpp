@@ -0,0 +1,119 @@
+/*
+ * PlexDirectoryCache.cpp
+ *
+ * Conditional-GET cache for Plex Media Server listings.
+ */
+#include "stdafx.h"
+#include "PlexDirectoryCache.h"
+#include "FileItem.h"
+
+using namespace std;
+using namespace DIRECTORY;
+
+// Bounds on what we keep around, whichever is hit first evicts the least recently used listing.
+#define MAX_CACHED_LISTINGS 100
+#define MAX_CACHED_ITEMS    20000
+
+CPlexDirectoryCache g_plexDirectoryCache;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryCache::CPlexDirectoryCache()
+  : m_totalItems(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryCache::~CPlexDirectoryCache()
+{
+  Clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectoryCache::GetListing(const CStdString& key, CStdString& etag, CStdString& lastModified,
+                                     CFileItemListPtr& items, DIR_CACHE_TYPE& cacheType)
+{
+  CSingleLock lock(m_cs);
+
+  MAPENTRIES::iterator it = m_entries.find(key);
+  if (it == m_entries.end())
+    return false;
+
+  // Bump it to the front.
+  m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru);
+
+  etag = it->second.m_etag;
+  lastModified = it->second.m_lastModified;
+  items = it->second.m_items;
+  cacheType = it->second.m_cacheType;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::SetListing(const CStdString& key, const CStdString& etag, const CStdString& lastModified,
+                                     const CFileItemList& items, int offset, DIR_CACHE_TYPE cacheType)
+{
+  // Without a validator there's no way to revalidate, so there's no point keeping it.
+  if (etag.empty() && lastModified.empty())
+  {
+    Remove(key);
+    return;
+  }
+
+  CFileItemListPtr copy(new CFileItemList());
+  copy->Assign(items);
+
+  // Assign leaves the list's own fanart behind.
+  if (items.GetQuickFanart().size() > 0)
+    copy->SetQuickFanart(items.GetQuickFanart());
+
+  for (int i=0; i<offset && copy->Size() > 0; i++)
+    copy->Remove(0);
+
+  CSingleLock lock(m_cs);
+
+  MAPENTRIES::iterator it = m_entries.find(key);
+  if (it != m_entries.end())
+    RemoveEntry(it);
+
+  m_lru.push_front(key);
+
+  CEntry& entry = m_entries[key];
+  entry.m_etag = etag;
+  entry.m_lastModified = lastModified;
+  entry.m_items = copy;
+  entry.m_cacheType = cacheType;
+  entry.m_lru = m_lru.begin();
+  m_totalItems += copy->Size();
+
+  // Evict from the back, but always keep the one we just added.
+  while (m_lru.size() > 1 && (m_lru.size() > MAX_CACHED_LISTINGS || m_totalItems > MAX_CACHED_ITEMS))
+    RemoveEntry(m_entries.find(m_lru.back()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::Remove(const CStdString& key)
+{
+  CSingleLock lock(m_cs);
+
+  MAPENTRIES::iterator it = m_entries.find(key);
+  if (it != m_entries.end())
+    RemoveEntry(it);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::Clear()
+{
+  CSingleLock lock(m_cs);
+
+  while (m_entries.size() > 0)
+    RemoveEntry(m_entries.begin());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::RemoveEntry(MAPENTRIES::iterator it)
+{
+  m_totalItems -= it->second.m_items->Size();
+
+  m_lru.erase(it->second.m_lru);
+  m_entries.erase(it);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ * PlexDirectoryCache.h
+ *
+ * Keeps the last parsed listing of Plex Media Server URLs together with the
+ * validators (ETag/Last-Modified) the server sent with it, so that a listing
+ * can be revalidated with a conditional GET and reused on 304 Not Modified.
+ */
+#include <list>
+#include <map>
+#include <boost/shared_ptr.hpp>
+
+#include "IDirectory.h"
+
+class CFileItemList;
+typedef boost::shared_ptr<CFileItemList> CFileItemListPtr;
+
+namespace DIRECTORY
+{
+class CPlexDirectoryCache
+{
+ public:
+  CPlexDirectoryCache();
+  virtual ~CPlexDirectoryCache();
+
+  // Returns false if there's no listing cached for the key. The returned
+  // list is never modified once cached, so it can be used outside the lock.
+  bool GetListing(const CStdString& key, CStdString& etag, CStdString& lastModified,
+                  CFileItemListPtr& items, DIR_CACHE_TYPE& cacheType);
+
+  // Stores a copy of items, skipping the first "offset" which aren't part of the container.
+  void SetListing(const CStdString& key, const CStdString& etag, const CStdString& lastModified,
+                  const CFileItemList& items, int offset, DIR_CACHE_TYPE cacheType);
+
+  void Remove(const CStdString& key);
+  void Clear();
+
+ protected:
+
+  struct CEntry
+  {
+    CStdString       m_etag;
+    CStdString       m_lastModified;
+    CFileItemListPtr m_items;
+    DIR_CACHE_TYPE   m_cacheType;
+    std::list<CStdString>::iterator m_lru;
+  };
+
+  typedef std::map<CStdString, CEntry> MAPENTRIES;
+
+  void RemoveEntry(MAPENTRIES::iterator it);
+
+  MAPENTRIES            m_entries;
+  std::list<CStdString> m_lru;        // Most recently used first.
+  int                   m_totalItems;
+  CCriticalSection      m_cs;
+};
+}
+
+extern DIRECTORY::CPlexDirectoryCache g_plexDirectoryCache;
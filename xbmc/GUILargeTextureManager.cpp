@@ -21,94 +21,280 @@
 
 #include "stdafx.h"
 #include "GUILargeTextureManager.h"
+#include "GUIWindowManager.h"
 #include "Picture.h"
 #include "GUISettings.h"
+#include "Settings.h"
 #include "Surface.h"
 #include "FileItem.h"
 #include "Util.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// decoders run in parallel up to the number of cores, and exit after being idle for a while
+#define MAX_DECODERS            4
+#define DECODER_IDLE_TIMEOUT    5000
+
+// decoded images waiting for the rendering thread, decoders block once this many are ready
+#define MAX_DECODED_IMAGES      4
+
+// roughly one full HD image per frame, but always at least one image
+#define UPLOAD_BYTES_PER_FRAME  (1920 * 1080 * 4)
 
 CGUILargeTextureManager g_largeTextureManager;
 
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
-  m_running = false;
+  m_numDecoders = 0;
+  m_numIdle = 0;
+  m_stopping = false;
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
 {
-  m_bStop = true;
-  m_listEvent.Set();
-  StopThread();
+  Stop();
 }
 
-// Process loop for this thread
-// Check and deallocate images that have been finished with.
-// And allocate new images that have been queued.
-// Once there's nothing queued or allocated, end the thread.
-void CGUILargeTextureManager::Process()
+void CGUILargeTextureManager::Stop()
 {
-  // lock item list
   CSingleLock lock(m_listSection);
-  m_running = true;
-
-  while (m_queued.size() && !m_bStop)
-  { // load the top item in the queue
-    // take a copy of the details required for the load, as
-    // it may be no longer required by the time the load is complete
-    CLargeTexture *image = m_queued[0];
-    CStdString path = image->GetPath();
+  m_stopping = true;
+  m_queued.clear();
+
+  // wake them all up so they notice, and wait for them to go
+  for (int i = 0; m_numDecoders > 0 && i < 100; i++)
+  {
     lock.Leave();
-    // load the image using our image lib
-    SDL_Surface * texture = NULL;
-    CPicture pic;
-    CFileItem file(path, false);
-    if (file.IsPicture() && !(file.IsZIP() || file.IsRAR() || file.IsCBR() || file.IsCBZ())) // ignore non-pictures
-    { // check for filename only (i.e. lookup in skin/media/)
-      CStdString loadPath(path);
-      if ((size_t)path.FindOneOf("/\\") == CStdString::npos)
-      {
-        loadPath = g_TextureManager.GetTexturePath(path);
-      }
-      //texture = pic.Load(loadPath, std::min(g_graphicsContext.GetWidth(), 2048), std::min(g_graphicsContext.GetHeight(), 1080));
-      texture = pic.Load(loadPath, 2048, 1080); //std::min(g_graphicsContext.GetWidth(), 2048), std::min(g_graphicsContext.GetHeight(), 1080));
-    }
-    // and add to our allocated list
+    m_workEvent.Set();
+    m_uploadEvent.Set();
+    Sleep(50);
     lock.Enter();
-    if (m_queued.size() && m_queued[0]->GetPath() == path)
+  }
+
+  while (m_decoded.size())
+  {
+    FreeDecodedImage(m_decoded.front());
+    m_decoded.pop_front();
+  }
+}
+
+CGUILargeTextureManager::CDecoder::CDecoder(CGUILargeTextureManager &manager)
+  : m_manager(manager)
+{
+  SetName("Large Texture Decoder");
+  Create(true);
+}
+
+// Process loop for the decoders
+// Decode the most recently queued image and hand it over for uploading.
+// Once there's been nothing queued for a while, end the thread.
+void CGUILargeTextureManager::CDecoder::Process()
+{
+  while (true)
+  {
+    CStdString path;
+    if (m_manager.GetWork(path))
     {
-      // still have the same image in the queue, so move it across to the
-      // allocated list, even if it doesn't exist
-      CLargeTexture *image = m_queued[0];
-      image->SetTexture(texture, pic.GetWidth(), pic.GetHeight(), (g_guiSettings.GetBool("pictures.useexifrotation") && pic.GetExifInfo()->Orientation) ? pic.GetExifInfo()->Orientation - 1: 0);
-      m_allocated.push_back(image);
-      m_queued.erase(m_queued.begin());
+      CDecodedImage image;
+      Decode(path, image);
+      m_manager.AddDecodedImage(image);
     }
-    else
+    else if (!m_manager.WaitForWork())
+      break;
+  }
+}
+
+void CGUILargeTextureManager::CDecoder::Decode(const CStdString &path, CDecodedImage &image)
+{
+  image.m_path = path;
+  image.m_texture = NULL;
+  image.m_width = 0;
+  image.m_height = 0;
+  image.m_orientation = 0;
+
+  // load the image using our image lib
+  CPicture pic;
+  CFileItem file(path, false);
+  if (file.IsPicture() && !(file.IsZIP() || file.IsRAR() || file.IsCBR() || file.IsCBZ())) // ignore non-pictures
+  { // check for filename only (i.e. lookup in skin/media/)
+    CStdString loadPath(path);
+    if ((size_t)path.FindOneOf("/\\") == CStdString::npos)
+    {
+      loadPath = g_TextureManager.GetTexturePath(path);
+    }
+    //texture = pic.Load(loadPath, std::min(g_graphicsContext.GetWidth(), 2048), std::min(g_graphicsContext.GetHeight(), 1080));
+    SDL_Surface * texture = pic.Load(loadPath, 2048, 1080); //std::min(g_graphicsContext.GetWidth(), 2048), std::min(g_graphicsContext.GetHeight(), 1080));
+    if (texture)
+    {
+#ifdef HAS_SDL_OPENGL
+      // copy the pixels into texture layout here, leaving only the upload for the rendering thread
+      image.m_texture = new CGLTexture(texture, false, true);
+#else
+      image.m_texture = texture;
+#endif
+    }
+  }
+  image.m_width = pic.GetWidth();
+  image.m_height = pic.GetHeight();
+  image.m_orientation = (g_guiSettings.GetBool("pictures.useexifrotation") && pic.GetExifInfo()->Orientation) ? pic.GetExifInfo()->Orientation - 1: 0;
+}
+
+bool CGUILargeTextureManager::GetWork(CStdString &path)
+{
+  CSingleLock lock(m_listSection);
+  if (m_stopping || m_queued.empty())
+    return false;
+
+  // most recent first, it's the one most likely to still be on screen
+  path = m_queued.back();
+  m_queued.pop_back();
+
+  // pass the word on if there's more to do
+  if (m_queued.size())
+    m_workEvent.Set();
+
+  return true;
+}
+
+bool CGUILargeTextureManager::WaitForWork()
+{
+  CSingleLock lock(m_listSection);
+  m_numIdle++;
+  lock.Leave();
+
+  bool woken = m_workEvent.WaitMSec(DECODER_IDLE_TIMEOUT);
+
+  lock.Enter();
+  m_numIdle--;
+
+  if (m_stopping || (!woken && m_queued.empty()))
+  {
+    m_numDecoders--;
+    return false;
+  }
+  return true;
+}
+
+void CGUILargeTextureManager::AddDecodedImage(const CDecodedImage &image)
+{
+  CSingleLock lock(m_listSection);
+  while (m_decoded.size() >= MAX_DECODED_IMAGES && !m_stopping)
+  {
+    lock.Leave();
+    m_uploadEvent.WaitMSec(100);
+    lock.Enter();
+  }
+  m_decoded.push_back(image);
+}
+
+void CGUILargeTextureManager::FreeDecodedImage(CDecodedImage &image)
+{
+  if (image.m_texture)
+#ifdef HAS_SDL_OPENGL
+    delete image.m_texture;
+#else
+    SDL_FreeSurface(image.m_texture);
+#endif
+  image.m_texture = NULL;
+}
+
+void CGUILargeTextureManager::UploadDecodedImages()
+{
+  CSingleLock lock(m_listSection);
+  unsigned int uploaded = 0;
+  while (m_decoded.size() && uploaded < UPLOAD_BYTES_PER_FRAME)
+  {
+    CDecodedImage image = m_decoded.front();
+    m_decoded.pop_front();
+    m_uploadEvent.Set();
+
+    textureIterator it = m_pending.find(image.m_path);
+    if (it == m_pending.end())
     { // no need for the texture any more
-      SDL_FreeSurface(texture);
-      texture = NULL;
+      FreeDecodedImage(image);
+      continue;
     }
+
+    // only the rendering thread touches m_pending, so it can't go away while we upload
     lock.Leave();
-    m_listEvent.WaitMSec(1000);
+#ifdef HAS_SDL_OPENGL
+    if (image.m_texture)
+      image.m_texture->LoadToGPU();
+#endif
     lock.Enter();
+
+    // and move it across to the allocated list, even if it doesn't exist
+    CLargeTexture *texture = it->second;
+    texture->SetTexture(image.m_texture, image.m_width, image.m_height, image.m_orientation);
+    m_pending.erase(it);
+    m_allocated[image.m_path] = texture;
+
+    // the image waiting on it needs a frame to show up in
+    m_gWindowManager.MarkDirty();
+
+    uploaded += max(texture->GetSize(), 1U);
   }
-  m_running = false;
 }
 
 void CGUILargeTextureManager::CleanupUnusedImages()
 {
   CSingleLock lock(m_listSection);
-  // check for items to remove from allocated list, and remove
-  listIterator it = m_allocated.begin();
-  while (it != m_allocated.end())
+
+  unsigned int maxUnusedSize = (unsigned int)g_advancedSettings.m_iImageMemoryCacheSize * 1024 * 1024;
+  if (maxUnusedSize == 0)
   {
-    CLargeTexture *image = *it;
-    if (image->DeleteIfRequired())
-      it = m_allocated.erase(it);
-    else
-      ++it;
+    // check for items to remove from allocated list, and remove
+    textureIterator it = m_allocated.begin();
+    while (it != m_allocated.end())
+    {
+      CLargeTexture *image = it->second;
+      if (image->DeleteIfRequired())
+        m_allocated.erase(it++);
+      else
+        ++it;
+    }
+  }
+  else
+  {
+    // keep released images around so that going back to them doesn't decode them again,
+    // dropping the ones released longest ago once they no longer fit.
+    unsigned int unusedSize = 0;
+    textureIterator it = m_allocated.begin();
+    while (it != m_allocated.end())
+    {
+      CLargeTexture *image = it->second;
+      // failed loads take no room, so there's nothing to gain from holding on to them
+      if (image->GetSize() == 0 && image->DeleteIfRequired())
+        m_allocated.erase(it++);
+      else
+      {
+        if (image->IsUnused())
+          unusedSize += image->GetSize();
+        ++it;
+      }
+    }
+
+    while (unusedSize > maxUnusedSize)
+    {
+      textureIterator oldest = m_allocated.end();
+      for (textureIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+      {
+        if (it->second->IsUnused() && (oldest == m_allocated.end() || it->second->GetTimeToDelete() < oldest->second->GetTimeToDelete()))
+          oldest = it;
+      }
+
+      if (oldest == m_allocated.end())
+        break;
+
+      CLargeTexture *image = oldest->second;
+      unusedSize -= image->GetSize();
+      m_allocated.erase(oldest);
+      delete image;
+    }
   }
-  m_listEvent.Set();
 }
 
 // if available, increment reference count, and return the image.
@@ -121,20 +307,17 @@ CGLTexture * CGUILargeTextureManager::GetImage(const CStdString &path, int &widt
 {
   // note: max size to load images: 2048x1024? (8MB)
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  textureIterator it = m_allocated.find(path);
+  if (it != m_allocated.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
-    {
-      if (firstRequest)
-        image->AddRef();
-      width = image->GetWidth();
-      height = image->GetHeight();
-      orientation = image->GetOrientation();
-      return image->GetTexture();
-    }
+    CLargeTexture *image = it->second;
+    if (firstRequest)
+      image->AddRef();
+    width = image->GetWidth();
+    height = image->GetHeight();
+    orientation = image->GetOrientation();
+    return image->GetTexture();
   }
-  lock.Leave();
 
   if (firstRequest)
     QueueImage(path);
@@ -145,52 +328,48 @@ CGLTexture * CGUILargeTextureManager::GetImage(const CStdString &path, int &widt
 void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately)
 {
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  textureIterator it = m_allocated.find(path);
+  if (it != m_allocated.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
-    {
-      if (image->DecrRef(immediately) && immediately)
-        m_allocated.erase(it);
-      return;
-    }
+    if (it->second->DecrRef(immediately) && immediately)
+      m_allocated.erase(it);
+    return;
   }
-  for (listIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+
+  it = m_pending.find(path);
+  if (it != m_pending.end() && it->second->DecrRef(true))
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path && image->DecrRef(true))
-    {
-      m_queued.erase(it);
-      return;
-    }
+    // scrolled away before it was loaded, so don't bother decoding it
+    m_pending.erase(it);
+    deque<CStdString>::iterator queued = find(m_queued.begin(), m_queued.end(), path);
+    if (queued != m_queued.end())
+      m_queued.erase(queued);
   }
 }
 
-// queue the image, and start the background loader if necessary
+// queue the image, and start another decoder if necessary
 void CGUILargeTextureManager::QueueImage(const CStdString &path)
 {
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  textureIterator it = m_pending.find(path);
+  if (it != m_pending.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
-    {
-      image->AddRef();
-      return; // already queued
-    }
+    it->second->AddRef();
+    return; // already queued
   }
 
   // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  m_queued.push_back(image);
-  m_listEvent.Set();
-  
-  if(m_running)
+  m_pending[path] = new CLargeTexture(path);
+  if (m_stopping)
     return;
 
-  lock.Leave(); // done with our lock
+  m_queued.push_back(path);
+  m_workEvent.Set();
 
-  StopThread();
-  Create();
+  static int maxDecoders = max(1, min(MAX_DECODERS, g_cpuInfo.getCPUCount()));
+  if ((int)m_queued.size() > m_numIdle && m_numDecoders < maxDecoders)
+  {
+    m_numDecoders++;
+    new CDecoder(*this);
+  }
 }
-
@@ -29,15 +29,15 @@
 #endif
 
 #include <assert.h>
+#include <deque>
+#include <map>
 
-class CGUILargeTextureManager : public CThread
+class CGUILargeTextureManager
 {
 public:
   CGUILargeTextureManager();
   virtual ~CGUILargeTextureManager();
 
-  virtual void Process();
-
 #ifdef HAS_SDL_2D
   SDL_Surface * GetImage(const CStdString &path, int &width, int &height, int &orientation, bool firstRequest);
 #else
@@ -47,6 +47,12 @@ public:
 
   void CleanupUnusedImages();
 
+  // called every frame from the rendering thread to take in some of the images that have been decoded
+  void UploadDecodedImages();
+
+  // cancels outstanding loads and waits for the decoders to exit
+  void Stop();
+
 protected:
   class CLargeTexture
   {
@@ -60,6 +66,7 @@ protected:
       m_texture = NULL;
       m_refCount = 1;
       m_timeToDelete = 0;
+      m_size = 0;
     };
 
     virtual ~CLargeTexture()
@@ -100,20 +107,21 @@ protected:
       return false;
     };
 
+    bool IsUnused() const { return m_refCount == 0; };
+    unsigned int GetTimeToDelete() const { return m_timeToDelete; };
+
+#ifdef HAS_SDL_OPENGL
+    void SetTexture(CGLTexture * texture, int width, int height, int orientation)
+#else
     void SetTexture(SDL_Surface * texture, int width, int height, int orientation)
+#endif
     {
       assert(m_texture == NULL);
-#ifdef HAS_SDL_OPENGL
-      if (texture)
-        m_texture = new CGLTexture(texture, false, true);
-      else
-        m_texture = NULL; // failed to load the image
-#else
       m_texture = texture;
-#endif
       m_width = width;
       m_height = height;
       m_orientation = orientation;
+      m_size = texture ? width * height * 4 : 0;
     };
 
 #ifdef HAS_SDL_OPENGL
@@ -125,6 +133,7 @@ protected:
     int GetHeight() const { return m_height; };
     int GetOrientation() const { return m_orientation; };
     const CStdString &GetPath() const { return m_path; };
+    unsigned int GetSize() const { return m_size; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -140,19 +149,62 @@ protected:
     int m_height;
     int m_orientation;
     unsigned int m_timeToDelete;
+    unsigned int m_size;
+  };
+
+  // an image a decoder has finished with, waiting for the rendering thread
+  struct CDecodedImage
+  {
+    CStdString m_path;
+#ifdef HAS_SDL_OPENGL
+    CGLTexture * m_texture;
+#else
+    SDL_Surface * m_texture;
+#endif
+    int m_width;
+    int m_height;
+    int m_orientation;
   };
 
+  // reads, decodes and scales queued images, many of these run at once
+  class CDecoder : public CThread
+  {
+  public:
+    CDecoder(CGUILargeTextureManager &manager);
+    virtual void Process();
+
+  private:
+    void Decode(const CStdString &path, CDecodedImage &image);
+
+    CGUILargeTextureManager &m_manager;
+  };
+  friend class CDecoder;
+
   void QueueImage(const CStdString &path);
 
+  // used by the decoders
+  bool GetWork(CStdString &path);
+  bool WaitForWork();
+  void AddDecodedImage(const CDecodedImage &image);
+
+  void FreeDecodedImage(CDecodedImage &image);
+
 private:
-  std::vector<CLargeTexture *> m_queued;
-  std::vector<CLargeTexture *> m_allocated;
-  typedef std::vector<CLargeTexture *>::iterator listIterator;
+  typedef std::map<CStdString, CLargeTexture *> textureMap;
+  typedef textureMap::iterator textureIterator;
+
+  textureMap m_allocated;               // ready for rendering
+  textureMap m_pending;                 // requested, but not yet uploaded
+  std::deque<CStdString> m_queued;      // paths waiting for a decoder, most recent request last
+  std::deque<CDecodedImage> m_decoded;  // waiting to be uploaded, oldest first
+
+  int m_numDecoders;
+  int m_numIdle;
+  bool m_stopping;
 
   CCriticalSection m_listSection;
-  CEvent m_listEvent;
-  bool m_running;
+  CEvent m_workEvent;     // something was queued
+  CEvent m_uploadEvent;   // there's room for more decoded images
 };
 
 extern CGUILargeTextureManager g_largeTextureManager;
-
@@ -101,6 +101,48 @@ class MediaRefresher : public CThread
   volatile bool m_canDie;
 };
 
+class MediaPageLoader : public CThread
+{
+ public:
+  
+  MediaPageLoader(const string& path, int start, int size)
+    : m_path(path)
+    , m_start(start)
+    , m_plexDir(true, false)
+    , m_doneLoading(false)
+    , m_canDie(false)
+  {
+    m_plexDir.SetContainerRange(start, size);
+    Create(true);
+  }
+  
+  virtual void Process()
+  {
+    // Fetch the page.
+    m_plexDir.GetDirectory(m_path, m_itemList);
+    m_doneLoading = true;
+    
+    // Wait until I can die.
+    while (m_canDie == false)
+      Sleep(100);
+  }
+  
+  bool            isDone() const   { return m_doneLoading; }
+  const string&   getPath() const  { return m_path; }
+  int             getStart() const { return m_start; }
+  CFileItemList&  getItemList()    { return m_itemList; }
+  void            die()            { m_canDie = true; }
+  
+ private:
+  
+  string        m_path;
+  int           m_start;
+  CPlexDirectory m_plexDir;
+  CFileItemList m_itemList;
+  volatile bool m_doneLoading;
+  volatile bool m_canDie;
+};
+
 CGUIMediaWindow::CGUIMediaWindow(DWORD id, const char *xmlFile)
     : CGUIWindow(id, xmlFile)
 {
@@ -111,6 +153,8 @@ CGUIMediaWindow::CGUIMediaWindow(DWORD id, const char *xmlFile)
   m_wasDirectoryListingCancelled = false;
   m_isRefreshing = false;
   m_mediaRefresher = 0;
+  m_pageLoader = 0;
+  m_lastPagedItem = -1;
 
   m_guiState.reset(CGUIViewState::GetViewState(GetID(), *m_vecItems));
 }
@@ -120,6 +164,9 @@ CGUIMediaWindow::~CGUIMediaWindow()
   if (m_mediaRefresher)
     m_mediaRefresher->die();
   
+  if (m_pageLoader)
+    m_pageLoader->die();
+  
   delete m_vecItems;
 }
 
@@ -317,6 +364,9 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
         int iItem = m_viewControl.GetSelectedItem();
         int iAction = message.GetParam1();
         if (iItem < 0) break;
+        
+        // Items of paged listings which haven't been fetched yet can't be used.
+        if (CPlexDirectory::IsPlaceholder(m_vecItems->Get(iItem))) break;
         if (iAction == ACTION_SELECT_ITEM || iAction == ACTION_MOUSE_LEFT_CLICK)
         {
           OnClick(iItem);
@@ -546,6 +596,8 @@ void CGUIMediaWindow::ClearFileItems()
 {
   m_viewControl.Clear();
   m_vecItems->Clear(); // will clean up everything
+  
+  m_lastPagedItem = -1;
 }
 
 // \brief Sorts Fileitems based on the sort method and sort oder provided by guiViewState
@@ -623,6 +675,9 @@ bool CGUIMediaWindow::GetDirectory(const CStdString &strDirectory, CFileItemList
     newItems.Add(pItem);
   }
 
+  // Large Plex containers are fetched a page at a time as the user scrolls.
+  newItems.SetProperty("pagedListing", true);
+  
   // see if we can load a previously cached folder
   CFileItemList cachedItems(strDirectory);
   if (!strDirectory.IsEmpty() && CUtil::IsPlexMediaServer(strDirectory) == false && cachedItems.Load())
@@ -916,6 +971,7 @@ bool CGUIMediaWindow::OnClick(int iItem)
 {
   if ( iItem < 0 || iItem >= (int)m_vecItems->Size() ) return true;
   CFileItemPtr pItem = m_vecItems->Get(iItem);
+  if (CPlexDirectory::IsPlaceholder(pItem)) return true;
 
   if (pItem->IsParentFolder())
   {
@@ -1299,11 +1355,19 @@ void CGUIMediaWindow::SetHistoryForPath(const CStdString& strDirectory)
 // This function is called by OnClick()
 bool CGUIMediaWindow::OnPlayMedia(int iItem)
 {
-  return OnPlayMedia(m_vecItems->Get(iItem).get());
+  CFileItemPtr pItem = m_vecItems->Get(iItem);
+  if (!pItem || CPlexDirectory::IsPlaceholder(pItem))
+    return false;
+  
+  return OnPlayMedia(pItem.get());
 }
 
 bool CGUIMediaWindow::OnPlayMedia(CFileItem* pItem)
 {
+  // There's nothing to play until a placeholder has been filled in.
+  if (CPlexDirectory::IsPlaceholder(pItem))
+    return false;
+  
   // Reset Playlistplayer, playback started now does
   // not use the playlistplayer.
   g_playlistPlayer.Reset();
@@ -1692,5 +1756,102 @@ void CGUIMediaWindow::Render()
     }
   }
   
+  UpdatePagedItems();
+  
+  // Thumbnails around the selection are loaded before the rest.
+  if (GetBackgroundLoader())
+    GetBackgroundLoader()->SetFocusItem(m_viewControl.GetSelectedItem());
+  
   CGUIWindow::Render();
 }
+
+void CGUIMediaWindow::UpdatePagedItems()
+{
+  int containerSize = m_vecItems->GetPropertyInt("containerSize");
+  
+  // See if a page has come in.
+  if (m_pageLoader && m_pageLoader->isDone())
+  {
+    if (m_pageLoader->getPath() == m_vecItems->m_strPath && containerSize > 0)
+    {
+      // Don't keep asking for a page the server won't give us until the selection moves.
+      if (FillPagedItems(m_pageLoader->getStart(), m_pageLoader->getItemList()) == 0)
+        m_lastPagedItem = m_viewControl.GetSelectedItem();
+    }
+    
+    m_pageLoader->die();
+    m_pageLoader = 0;
+  }
+  
+  if (containerSize == 0 || m_pageLoader)
+    return;
+  
+  // Only look again when the selection moves.
+  int selectedItem = m_viewControl.GetSelectedItem();
+  if (selectedItem == m_lastPagedItem)
+    return;
+  
+  // Look for items still to be fetched in the window around the selected item. The listing
+  // may have been sorted, so it's the placeholders' own container indexes which count.
+  int pageSize = g_advancedSettings.m_iPlexPageSize;
+  int first = max(selectedItem - pageSize/2, 0);
+  int last = min(selectedItem + pageSize/2, m_vecItems->Size() - 1);
+  int missing = -1;
+  
+  for (int i=first; i<=last; i++)
+  {
+    CFileItemPtr pItem = m_vecItems->Get(i);
+    if (CPlexDirectory::IsPlaceholder(pItem))
+    {
+      int index = CPlexDirectory::GetPlaceholderIndex(pItem);
+      if (missing < 0 || index < missing)
+        missing = index;
+    }
+  }
+  
+  // Fetch the page starting with the first missing item.
+  if (missing >= 0)
+  {
+    m_pageLoader = new MediaPageLoader(m_vecItems->m_strPath, missing, pageSize);
+    return;
+  }
+  
+  // Everything around the selection is in.
+  m_lastPagedItem = selectedItem;
+}
+
+int CGUIMediaWindow::FillPagedItems(int start, CFileItemList& page)
+{
+  OnPrepareFileItems(page);
+  page.FillInDefaultIcons();
+  
+  if (m_guiState.get())
+  {
+    LABEL_MASKS labelMasks;
+    m_guiState->GetSortMethodLabelMasks(labelMasks);
+    FormatItemLabels(page, labelMasks);
+  }
+  
+  // Fill the placeholders in place, the containers are holding on to them. They're found by
+  // their container index rather than their position, which changes when the listing is sorted.
+  map<int, CFileItemPtr> filledItems;
+  for (int i=0; i<m_vecItems->Size() && (int)filledItems.size()<page.Size(); i++)
+  {
+    CFileItemPtr pItem = m_vecItems->Get(i);
+    if (CPlexDirectory::IsPlaceholder(pItem) == false)
+      continue;
+    
+    int index = CPlexDirectory::GetPlaceholderIndex(pItem) - start;
+    if (index < 0 || index >= page.Size())
+      continue;
+    
+    *pItem = *page[index];
+    filledItems[i] = pItem;
+  }
+  
+  // Queue up their thumbnails alongside the rest of the listing's.
+  if (GetBackgroundLoader())
+    GetBackgroundLoader()->Enqueue(filledItems);
+  
+  return filledItems.size();
+}
@@ -30,6 +30,7 @@
 
 class CFileItemList;
 class MediaRefresher;
+class MediaPageLoader;
 
 // base class for all media windows
 class CGUIMediaWindow : public CGUIWindow
@@ -94,6 +95,8 @@ protected:
   void UpdateFileList();
   virtual void OnDeleteItem(int iItem);
   void OnRenameItem(int iItem);
+  void UpdatePagedItems();
+  int FillPagedItems(int start, CFileItemList& page);
 
 protected:
   virtual CBackgroundInfoLoader* GetBackgroundLoader() { return 0; }
@@ -117,6 +120,10 @@ protected:
   int m_iSelectedItem;
   
   MediaRefresher* m_mediaRefresher;
+  
+  // Lazy filling of paged listings.
+  MediaPageLoader* m_pageLoader;
+  int              m_lastPagedItem;
   bool m_wasDirectoryListingCancelled;
   CStopWatch m_refreshTimer;
   bool m_isRefreshing;
@@ -276,6 +276,9 @@ void CGUIWindowSlideShow::Render()
   int iSlides = m_slides->Size();
   if (!iSlides) return ;
 
+  // slide effects and transitions are stepped per frame
+  m_gWindowManager.MarkDirty();
+
   // Create our background loader if necessary
   if (!m_pBackgroundLoader)
   {
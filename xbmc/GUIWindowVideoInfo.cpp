@@ -46,6 +46,7 @@
 
 #include "HTTP.h"
 #include "PlexDirectory.h"
+#include "PlexImageCache.h"
 
 using namespace std;
 using namespace XFILE;
@@ -676,7 +677,7 @@ void CGUIWindowVideoInfo::OnGetThumb()
     string newPosterFile = CFileItem::GetCachedPlexMediaServerThumb(newPoster);
     bool   success = true;
     
-    if (CFile::Exists(newPosterFile) == false)
+    if (CPlexImageCache::Get()->Exists(newPosterFile) == false)
       success = AsyncDownloadMedia(newPoster, newPosterFile);
 
     if (success)
@@ -761,7 +762,7 @@ void CGUIWindowVideoInfo::OnGetBanner()
     string newBannerFile = CFileItem::GetCachedPlexMediaServerThumb(newBanner);
     bool   success = true;
     
-    if (CFile::Exists(newBannerFile) == false)
+    if (CPlexImageCache::Get()->Exists(newBannerFile) == false)
       success = AsyncDownloadMedia(newBanner, newBannerFile);
 
     if (success)
@@ -785,7 +786,7 @@ void CGUIWindowVideoInfo::OnGetFanart()
     string newFanartFile = CFileItem::GetCachedPlexMediaServerFanart(newFanart);
     bool   success = true;
     
-    if (CFile::Exists(newFanartFile) == false)
+    if (CPlexImageCache::Get()->Exists(newFanartFile) == false)
       success = AsyncDownloadMedia(newFanart, newFanartFile);
 
     if (success)
@@ -805,8 +806,7 @@ bool CGUIWindowVideoInfo::AsyncDownloadMedia(const string& remoteFile, const str
   CStdString tempFile = _P("Z:\\fanart_download.jpg");
   CAsyncFileCopy downloader;
   bool success = downloader.Copy(remoteFile, tempFile, g_localizeStrings.Get(13413));
-  CPicture pic;
-  pic.CacheImage(tempFile, localFile);
+  CPlexImageCache::Get()->CacheImage(tempFile, localFile);
   CFile::Delete(tempFile);
   
   return success;
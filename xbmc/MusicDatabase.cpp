@@ -48,12 +48,17 @@ using namespace DIRECTORY;
 using namespace MEDIA_DETECT;
 
 #define MUSIC_DATABASE_OLD_VERSION 1.6f
-#define MUSIC_DATABASE_VERSION        10
+#define MUSIC_DATABASE_VERSION        11
 #define MUSIC_DATABASE_NAME "MyMusic7.db"
 #define RECENTLY_ADDED_LIMIT  g_guiSettings.GetInt("musiclibrary.recentcount")
 #define RECENTLY_PLAYED_LIMIT g_guiSettings.GetInt("musiclibrary.recentcount")
 #define MIN_FULL_SEARCH_LENGTH 3
 
+// item types in the search index
+#define SEARCH_ARTIST 1
+#define SEARCH_ALBUM  2
+#define SEARCH_SONG   3
+
 using namespace CDDB;
 
 CMusicDatabase::CMusicDatabase(void)
@@ -159,6 +164,8 @@ bool CMusicDatabase::CreateTables()
                 "left outer join genre on album.idGenre=genre.idGenre "
                 "left outer join thumb on album.idThumb=thumb.idThumb "
                 "left outer join albuminfo on album.idAlbum=albumInfo.idAlbum");
+
+    CreateSearchIndex();
   }
   catch (...)
   {
@@ -170,6 +177,20 @@ bool CMusicDatabase::CreateTables()
   return true;
 }
 
+void CMusicDatabase::CreateSearchIndex()
+{
+  CDatabase::CreateSearchIndex();
+
+  // keep it in sync with the cleanup functions, which delete in bulk
+  CLog::Log(LOGINFO, "create searchindex triggers");
+  CStdString strSQL = FormatSQL("CREATE TRIGGER tgrSearchArtist AFTER delete ON artist FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idArtist; END", SEARCH_ARTIST);
+  m_pDS->exec(strSQL.c_str());
+  strSQL = FormatSQL("CREATE TRIGGER tgrSearchAlbum AFTER delete ON album FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idAlbum; END", SEARCH_ALBUM);
+  m_pDS->exec(strSQL.c_str());
+  strSQL = FormatSQL("CREATE TRIGGER tgrSearchSong AFTER delete ON song FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idSong; END", SEARCH_SONG);
+  m_pDS->exec(strSQL.c_str());
+}
+
 void CMusicDatabase::AddSong(const CSong& song, bool bCheck)
 {
   CStdString strSQL;
@@ -256,6 +277,7 @@ void CMusicDatabase::AddSong(const CSong& song, bool bCheck)
 
       m_pDS->exec(strSQL.c_str());
       lSongId = (long)sqlite3_last_insert_rowid(m_pDB->getHandle());
+      SetSearchText(SEARCH_SONG, lSongId, song.strTitle);
     }
 
     // add extra artists and genres
@@ -325,6 +347,7 @@ long CMusicDatabase::AddAlbum(const CStdString& strAlbum1, long lArtistId, const
 
       CAlbumCache album;
       album.idAlbum = (long)sqlite3_last_insert_rowid(m_pDB->getHandle());
+      SetSearchText(SEARCH_ALBUM, album.idAlbum, strAlbum);
       album.strAlbum = strAlbum;
       album.idArtist = lArtistId;
       album.strArtist = strArtist;
@@ -441,6 +464,7 @@ long CMusicDatabase::AddArtist(const CStdString& strArtist1)
       strSQL=FormatSQL("insert into artist (idArtist, strArtist) values( NULL, '%s' )", strArtist.c_str());
       m_pDS->exec(strSQL.c_str());
       int idArtist = (long)sqlite3_last_insert_rowid(m_pDB->getHandle());
+      SetSearchText(SEARCH_ARTIST, idArtist, strArtist);
       m_artistCache.insert(pair<CStdString, int>(strArtist1, idArtist));
       return idArtist;
     }
@@ -926,15 +950,12 @@ bool CMusicDatabase::SearchArtists(const CStdString& search, CFileItemList &arti
     // Exclude "Various Artists"
     long lVariousArtistId = AddArtist(g_localizeStrings.Get(340));
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=FormatSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and idArtist <> %i "
-                                , search.c_str(), search.c_str(), lVariousArtistId );
-    else
-      strSQL=FormatSQL("select * from artist "
-                                "where strArtist like '%s%%' and idArtist <> %i "
-                                , search.c_str(), lVariousArtistId );
+    // short searches only match the start of the name
+    CStdString strHits = GetSearchSQL(SEARCH_ARTIST, search, search.GetLength() < MIN_FULL_SEARCH_LENGTH);
+    if (strHits.IsEmpty()) return false;
+
+    CStdString strSQL = "select artist.* from (" + strHits + ") as hits join artist on artist.idArtist=hits.idItem " +
+                        FormatSQL("where artist.idArtist <> %i order by hits.exact desc, hits.pos, artist.strArtist", lVariousArtistId);
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0)
@@ -1564,11 +1585,12 @@ bool CMusicDatabase::SearchSongs(const CStdString& search, CFileItemList &items)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=FormatSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
-    else
-      strSQL=FormatSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+    // short searches only match the start of the title
+    CStdString strHits = GetSearchSQL(SEARCH_SONG, search, search.GetLength() < MIN_FULL_SEARCH_LENGTH);
+    if (strHits.IsEmpty()) return false;
+
+    CStdString strSQL = "select songview.* from (" + strHits + ") as hits join songview on songview.idSong=hits.idItem "
+                        "order by hits.exact desc, hits.pos, songview.strTitle limit 1000";
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -1600,11 +1622,12 @@ bool CMusicDatabase::SearchAlbums(const CStdString& search, CFileItemList &album
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=FormatSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
-    else
-      strSQL=FormatSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+    // short searches only match the start of the name
+    CStdString strHits = GetSearchSQL(SEARCH_ALBUM, search, search.GetLength() < MIN_FULL_SEARCH_LENGTH);
+    if (strHits.IsEmpty()) return false;
+
+    CStdString strSQL = "select albumview.* from (" + strHits + ") as hits join albumview on albumview.idAlbum=hits.idItem "
+                        "order by hits.exact desc, hits.pos, albumview.strAlbum";
 
     if (!m_pDS->query(strSQL.c_str())) return false;
 
@@ -2978,12 +3001,27 @@ bool CMusicDatabase::UpdateOldVersion(int version)
                   "left outer join thumb on album.idThumb=thumb.idThumb "
                   "left outer join albuminfo on album.idAlbum=albumInfo.idAlbum");
     }
+    if (version < 11)
+    { // add the search index, and fill it
+      BeginTransaction();
+      CreateSearchIndex();
+      if (!RebuildSearchIndex(SEARCH_ARTIST, "select idArtist, strArtist from artist") ||
+          !RebuildSearchIndex(SEARCH_ALBUM, "select idAlbum, strAlbum from album") ||
+          !RebuildSearchIndex(SEARCH_SONG, "select idSong, strTitle from song"))
+      {
+        // leave it at the old version, so it's tried again next time
+        RollbackTransaction();
+        return false;
+      }
+      CommitTransaction();
+    }
 
     return true;
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "Error attempting to update the database version!");
+    RollbackTransaction();
     return false;
   }
   return true;
@@ -202,6 +202,7 @@ protected:
   std::map<CStdString, int /*CPathCache*/> m_thumbCache;
   std::map<CStdString, CAlbumCache> m_albumCache;
   virtual bool CreateTables();
+  virtual void CreateSearchIndex();
   long AddAlbum(const CStdString& strAlbum1, long lArtistId, const CStdString &extraArtists, const CStdString &strArtist1, long idThumb, long idGenre, const CStdString &extraGenres, long year);
   long AddGenre(const CStdString& strGenre);
   long AddArtist(const CStdString& strArtist);
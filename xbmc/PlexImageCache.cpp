@@ -0,0 +1,467 @@
+/*
+ * PlexImageCache.cpp
+ *
+ * Size-bounded index of the images cached from Plex Media Servers.
+ */
+#include "stdafx.h"
+#include "PlexImageCache.h"
+#include "FileItem.h"
+#include "FileSystem/File.h"
+#include "Picture.h"
+#include "Settings.h"
+#include "Util.h"
+
+using namespace std;
+using namespace XFILE;
+
+// Images which haven't been looked at in this long are dropped when the index is loaded.
+#define MAX_UNUSED_AGE  (3600*24*30)
+#define INDEX_FILE      "CacheIndex.txt"
+
+CPlexImageCache* CPlexImageCache::g_instance = 0;
+static CCriticalSection g_instanceLock;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexImageCache* CPlexImageCache::Get()
+{
+  CSingleLock lock(g_instanceLock);
+
+  if (g_instance == 0)
+    g_instance = new CPlexImageCache();
+
+  return g_instance;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Shutdown()
+{
+  CSingleLock lock(g_instanceLock);
+
+  if (g_instance)
+  {
+    g_instance->StopThread();
+    g_instance->Save();
+    delete g_instance;
+    g_instance = 0;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexImageCache::CPlexImageCache()
+  : m_totalSize(0)
+  , m_dirty(false)
+  , m_loaderRunning(false)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexImageCache::~CPlexImageCache()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexImageCache::Exists(const CStdString& localFile)
+{
+  CSingleLock lock(m_cs);
+
+  // Until the index has been read in, it only knows about what was added since.
+  bool inRoot = CheckRoot(localFile);
+  MAPENTRIES::iterator it = m_entries.find(localFile);
+  if (inRoot == false || (it == m_entries.end() && m_indexRoot != m_root))
+  {
+    lock.Leave();
+    return CFile::Exists(localFile);
+  }
+
+  if (it == m_entries.end())
+    return false;
+
+  // The index may be stale if we didn't shut down cleanly, so look at the disk once per session.
+  if (it->second.m_verified == false)
+  {
+    lock.Leave();
+    bool exists = CFile::Exists(localFile);
+    lock.Enter();
+
+    // Someone else may have been at it meanwhile.
+    it = m_entries.find(localFile);
+    if (it == m_entries.end())
+      return exists;
+
+    if (exists == false)
+    {
+      RemoveEntry(it);
+      m_dirty = true;
+      return false;
+    }
+
+    it->second.m_verified = true;
+  }
+
+  // Bump it to the front.
+  m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru);
+  it->second.m_accessed = time(0);
+  m_dirty = true;
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Expire(const CStdString& localFile, int maxAge)
+{
+  CSingleLock lock(m_cs);
+
+  bool inRoot = CheckRoot(localFile);
+  MAPENTRIES::iterator it = m_entries.find(localFile);
+  if (inRoot == false || (it == m_entries.end() && m_indexRoot != m_root))
+  {
+    lock.Leave();
+    if (CFile::Age(localFile) > maxAge)
+      CFile::Delete(localFile);
+
+    return;
+  }
+
+  if (it == m_entries.end() || time(0) - it->second.m_created <= maxAge)
+    return;
+
+  RemoveEntry(it);
+  m_dirty = true;
+  lock.Leave();
+
+  CFile::Delete(localFile);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexImageCache::CacheThumb(const CStdString& url, const CStdString& localFile)
+{
+  if (Exists(localFile))
+    return true;
+
+  CPicture pic;
+  if (pic.DoCreateThumbnail(url, localFile) == false)
+    return false;
+
+  Add(localFile);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexImageCache::CacheImage(const CStdString& url, const CStdString& localFile)
+{
+  if (Exists(localFile))
+    return true;
+
+  CPicture pic;
+  if (pic.CacheImage(url, localFile) == false)
+    return false;
+
+  Add(localFile);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Add(const CStdString& localFile)
+{
+  struct __stat64 st;
+  if (CFile::Stat(localFile, &st) != 0)
+    return;
+
+  vector<CStdString> victims;
+
+  CSingleLock lock(m_cs);
+  if (CheckRoot(localFile) == false)
+    return;
+
+  time_t now = time(0);
+  Insert(localFile, st.st_size, now, now, true);
+  Evict(victims);
+  m_dirty = true;
+  lock.Leave();
+
+  for (size_t i=0; i<victims.size(); i++)
+    CFile::Delete(victims[i]);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Remove(const CStdString& localFile)
+{
+  CSingleLock lock(m_cs);
+
+  if (CheckRoot(localFile))
+  {
+    MAPENTRIES::iterator it = m_entries.find(localFile);
+    if (it != m_entries.end())
+    {
+      RemoveEntry(it);
+      m_dirty = true;
+    }
+  }
+
+  lock.Leave();
+  CFile::Delete(localFile);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Save()
+{
+  CSingleLock lock(m_cs);
+
+  // Writing a half read index would lose whatever isn't in yet.
+  if (m_dirty == false || m_root.empty() || m_indexRoot != m_root)
+    return;
+
+  CStdString indexFile = GetIndexFile(m_root);
+  CStdString data = FormatIndex();
+  m_dirty = false;
+  lock.Leave();
+
+  WriteIndex(indexFile, data);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexImageCache::CheckRoot(const CStdString& localFile)
+{
+  // The cache folder depends on the profile, so follow it around.
+  CStdString root = _P(g_settings.GetPlexMediaServerThumbFolder());
+  if (root != m_root)
+  {
+    // The loader writes out the index we had, unless it was still reading it in.
+    if (m_dirty && m_indexRoot == m_root && m_root.empty() == false)
+    {
+      m_pendingSaveFile = GetIndexFile(m_root);
+      m_pendingSaveData = FormatIndex();
+    }
+
+    m_entries.clear();
+    m_lru.clear();
+    m_totalSize = 0;
+    m_root = root;
+    m_indexRoot.clear();
+    m_dirty = false;
+
+    // A loader which is still running notices the change by itself. Otherwise the last
+    // one has already let go of everything, and stopping it just reaps the thread.
+    if (m_loaderRunning == false)
+    {
+      StopThread();
+      m_loaderRunning = true;
+      Create();
+    }
+  }
+
+  return localFile.size() > m_root.size() &&
+         (localFile[m_root.size()] == '/' || localFile[m_root.size()] == '\\') &&
+         localFile.Left(m_root.size()) == m_root;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Process()
+{
+  while (true)
+  {
+    CStdString root, saveFile, saveData;
+    {
+      CSingleLock lock(m_cs);
+      if (m_bStop || (m_indexRoot == m_root && m_pendingSaveFile.empty()))
+      {
+        m_loaderRunning = false;
+        return;
+      }
+
+      root = m_root;
+      saveFile = m_pendingSaveFile;
+      saveData = m_pendingSaveData;
+      m_pendingSaveFile.clear();
+      m_pendingSaveData.clear();
+    }
+
+    if (saveFile.size() > 0)
+      WriteIndex(saveFile, saveData);
+
+    // First run with the index, pick up whatever is already in the folder.
+    vector<CRecord> records;
+    vector<CStdString> victims;
+    bool scanned = false;
+    if (ReadIndex(root, records, victims) == false)
+    {
+      ScanFolder(root, records);
+      scanned = true;
+    }
+
+    {
+      CSingleLock lock(m_cs);
+
+      // The profile changed while we were at it, so start over with the new folder.
+      if (root != m_root)
+        continue;
+
+      // What was added meanwhile has been used more recently than anything we read, so the
+      // records go in behind it, most recently used first.
+      for (vector<CRecord>::reverse_iterator it = records.rbegin(); it != records.rend(); ++it)
+      {
+        if (m_entries.find(it->m_file) == m_entries.end())
+          Insert(it->m_file, it->m_size, it->m_created, it->m_accessed, scanned, false);
+      }
+
+      Evict(victims);
+      m_indexRoot = root;
+      m_dirty = m_dirty || scanned || victims.size() > 0;
+
+      CLog::Log(LOGINFO, "%s - Indexed %d images (%lld KB) in %s, dropping %d", __FUNCTION__, (int)m_entries.size(), m_totalSize/1024, m_root.c_str(), (int)victims.size());
+    }
+
+    for (size_t i=0; i<victims.size(); i++)
+      CFile::Delete(victims[i]);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexImageCache::ReadIndex(const CStdString& root, vector<CRecord>& records, vector<CStdString>& victims)
+{
+  CFile file;
+  if (file.Open(GetIndexFile(root)) == false)
+    return false;
+
+  time_t now = time(0);
+
+  char line[1024];
+  while (file.ReadString(line, sizeof(line)))
+  {
+    long created, accessed;
+    long long size;
+    int pos = 0;
+
+    if (sscanf(line, "%ld %ld %lld %n", &created, &accessed, &size, &pos) < 3 || pos == 0)
+      continue;
+
+    CStdString relativePath = line + pos;
+    relativePath.TrimRight("\r\n");
+    if (relativePath.empty())
+      continue;
+
+    CRecord record;
+    CUtil::AddFileToFolder(root, relativePath, record.m_file);
+    record.m_size = size;
+    record.m_created = created;
+    record.m_accessed = accessed;
+
+    if (now - accessed > MAX_UNUSED_AGE)
+      victims.push_back(record.m_file);
+    else
+      records.push_back(record);
+  }
+  file.Close();
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::ScanFolder(const CStdString& root, vector<CRecord>& records)
+{
+  CFileItemList items;
+  CUtil::GetRecursiveListing(root, items, ".tbn");
+
+  time_t now = time(0);
+  for (int i=0; i<items.Size(); i++)
+  {
+    CRecord record;
+    record.m_file = _P(items[i]->m_strPath);
+    if (record.m_file.Left(root.size()) != root)
+      continue;
+
+    // The file's own date is the best guess of when it was cached, so it still expires on time.
+    record.m_size = items[i]->m_dwSize;
+    record.m_created = now;
+    if (items[i]->m_dateTime.IsValid())
+      items[i]->m_dateTime.GetAsTime(record.m_created);
+    record.m_accessed = now;
+
+    records.push_back(record);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::WriteIndex(const CStdString& indexFile, const CStdString& data)
+{
+  CFile file;
+  if (file.OpenForWrite(indexFile, true, true) == false)
+  {
+    CLog::Log(LOGERROR, "%s - Unable to write %s", __FUNCTION__, indexFile.c_str());
+    return;
+  }
+
+  file.Write(data.c_str(), data.size());
+  file.Close();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CStdString CPlexImageCache::FormatIndex() const
+{
+  CStdString data;
+
+  // Least recently used first, so loading it back in order rebuilds the list.
+  for (list<CStdString>::const_reverse_iterator it = m_lru.rbegin(); it != m_lru.rend(); ++it)
+  {
+    const CEntry& entry = m_entries.find(*it)->second;
+
+    CStdString line;
+    line.Format("%ld %ld %lld %s\n", (long)entry.m_created, (long)entry.m_accessed, entry.m_size, it->Mid(m_root.size()+1).c_str());
+    data += line;
+  }
+
+  return data;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Insert(const CStdString& localFile, __int64 size, time_t created, time_t accessed, bool verified, bool mostRecent)
+{
+  MAPENTRIES::iterator it = m_entries.find(localFile);
+  if (it != m_entries.end())
+    RemoveEntry(it);
+
+  if (mostRecent)
+    m_lru.push_front(localFile);
+  else
+    m_lru.push_back(localFile);
+
+  CEntry& entry = m_entries[localFile];
+  entry.m_size = size;
+  entry.m_created = created;
+  entry.m_accessed = accessed;
+  entry.m_verified = verified;
+  entry.m_lru = mostRecent ? m_lru.begin() : --m_lru.end();
+  m_totalSize += size;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::RemoveEntry(MAPENTRIES::iterator it)
+{
+  m_totalSize -= it->second.m_size;
+
+  m_lru.erase(it->second.m_lru);
+  m_entries.erase(it);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexImageCache::Evict(vector<CStdString>& victims)
+{
+  __int64 maxSize = (__int64)g_advancedSettings.m_iImageCacheSize * 1024 * 1024;
+  if (maxSize == 0)
+    return;
+
+  // Evict from the back, but always keep the most recent one.
+  while (m_lru.size() > 1 && m_totalSize > maxSize)
+  {
+    victims.push_back(m_lru.back());
+    RemoveEntry(m_entries.find(m_lru.back()));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CStdString CPlexImageCache::GetIndexFile(const CStdString& root)
+{
+  CStdString indexFile;
+  CUtil::AddFileToFolder(root, INDEX_FILE, indexFile);
+  return indexFile;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+ * PlexImageCache.h
+ *
+ * Keeps track of the thumbs, fanart and banners cached from Plex Media
+ * Servers. Lookups are answered from an in-memory index (persisted to an
+ * index file in the cache folder) instead of probing the filesystem, and
+ * the folder is kept under a size quota by evicting the least recently
+ * used images. The index is read in on a thread of its own, lookups go to
+ * the disk until it's there.
+ */
+#include <list>
+#include <map>
+#include <vector>
+
+#include "StdString.h"
+#include "utils/CriticalSection.h"
+#include "utils/Thread.h"
+
+class CPlexImageCache : public CThread
+{
+ public:
+
+  /// Get singleton instance.
+  static CPlexImageCache* Get();
+
+  /// Save the index and shut down.
+  static void Shutdown();
+
+  /// Is the file cached? Counts as a use. Files outside the cache folder are probed as usual.
+  bool Exists(const CStdString& localFile);
+
+  /// Drops the file if it was cached more than maxAge seconds ago.
+  void Expire(const CStdString& localFile, int maxAge);
+
+  /// Creates a thumbnail of the image at url as localFile, unless it's cached already.
+  bool CacheThumb(const CStdString& url, const CStdString& localFile);
+
+  /// Copies the image at url to localFile as is, unless it's cached already.
+  bool CacheImage(const CStdString& url, const CStdString& localFile);
+
+  /// Records a file which was written into the cache folder by someone else.
+  void Add(const CStdString& localFile);
+
+  /// Deletes the file and forgets about it.
+  void Remove(const CStdString& localFile);
+
+  /// Writes the index file, if anything changed since it was last written.
+  void Save();
+
+ protected:
+
+  CPlexImageCache();
+  virtual ~CPlexImageCache();
+
+  struct CEntry
+  {
+    __int64 m_size;
+    time_t  m_created;
+    time_t  m_accessed;
+    bool    m_verified;   // Seen on disk this session.
+    std::list<CStdString>::iterator m_lru;
+  };
+
+  typedef std::map<CStdString, CEntry> MAPENTRIES;
+
+  // An image as read from the index file or found in the folder.
+  struct CRecord
+  {
+    CStdString m_file;
+    __int64    m_size;
+    time_t     m_created;
+    time_t     m_accessed;
+  };
+
+  virtual void Process();
+
+  bool CheckRoot(const CStdString& localFile);
+  void Insert(const CStdString& localFile, __int64 size, time_t created, time_t accessed, bool verified, bool mostRecent = true);
+  void RemoveEntry(MAPENTRIES::iterator it);
+  void Evict(std::vector<CStdString>& victims);
+  CStdString FormatIndex() const;
+
+  // These only touch the disk, the lock isn't held.
+  static bool ReadIndex(const CStdString& root, std::vector<CRecord>& records, std::vector<CStdString>& victims);
+  static void ScanFolder(const CStdString& root, std::vector<CRecord>& records);
+  static void WriteIndex(const CStdString& indexFile, const CStdString& data);
+  static CStdString GetIndexFile(const CStdString& root);
+
+  MAPENTRIES            m_entries;
+  std::list<CStdString> m_lru;       // Most recently used first.
+  __int64               m_totalSize;
+  CStdString            m_root;      // Cache folder the index belongs to.
+  bool                  m_dirty;
+  CStdString            m_indexRoot; // Folder whose index has been read in, m_root once it's there.
+  bool                  m_loaderRunning;
+  CStdString            m_pendingSaveFile;  // The last folder's index, for the loader to write out.
+  CStdString            m_pendingSaveData;
+  CCriticalSection      m_cs;
+
+  static CPlexImageCache* g_instance;
+};
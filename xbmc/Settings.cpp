@@ -189,6 +189,7 @@ CSettings::CSettings(void)
   g_advancedSettings.m_DisableModChipDetection = true;
 
   g_advancedSettings.m_audioHeadRoom = 0;
+  g_advancedSettings.m_audioResampleQuality = 1;
   g_advancedSettings.m_karaokeSyncDelay = 0.0f;
 
   g_advancedSettings.m_videoSubsDelayRange = 10;
@@ -206,6 +207,7 @@ CSettings::CSettings(void)
   g_advancedSettings.m_videoPercentSeekForwardBig = 10;
   g_advancedSettings.m_videoPercentSeekBackwardBig = -10;
   g_advancedSettings.m_videoBlackBarColour = 1;
+  g_advancedSettings.m_videoRenderBuffers = 3;
   
   g_advancedSettings.m_musicUseTimeSeeking = true;
   g_advancedSettings.m_musicTimeSeekForward = 10;
@@ -304,6 +306,8 @@ CSettings::CSettings(void)
   g_advancedSettings.m_iTuxBoxZapWaitTime = 0; // Time in sec. Default 0:OFF
 
   g_advancedSettings.m_curlclienttimeout = 40;
+  g_advancedSettings.m_curlcachesize = 16;
+  g_advancedSettings.m_curlconnections = 4;
 
 #ifdef HAS_SDL
   g_advancedSettings.m_fullScreen = false;
@@ -324,6 +328,12 @@ CSettings::CSettings(void)
   
   g_advancedSettings.m_bEnableViewRestrictions = true;
   g_advancedSettings.m_bEnableKeyboardBacklightControl = false;
+  
+  g_advancedSettings.m_iPlexPageSize = 200;
+  g_advancedSettings.m_iDirectoryCacheSize = 16384;
+  g_advancedSettings.m_iImageCacheSize = 512;
+  g_advancedSettings.m_iImageMemoryCacheSize = 64;
+  g_advancedSettings.m_iGUIIdleRefresh = 250;
 }
 
 CSettings::~CSettings(void)
@@ -1209,6 +1219,7 @@ void CSettings::LoadAdvancedSettings()
   if (pElement)
   {
     GetInteger(pElement, "headroom", g_advancedSettings.m_audioHeadRoom, 0, 12);
+    GetInteger(pElement, "resamplequality", g_advancedSettings.m_audioResampleQuality, 0, 2);
     GetFloat(pElement, "karaokesyncdelay", g_advancedSettings.m_karaokeSyncDelay, -3.0f, 3.0f);
 
     XMLUtils::GetBoolean(pElement, "usetimeseeking", g_advancedSettings.m_musicUseTimeSeeking);
@@ -1243,6 +1254,7 @@ void CSettings::LoadAdvancedSettings()
     GetInteger(pElement, "percentseekforwardbig", g_advancedSettings.m_videoPercentSeekForwardBig, 0, 100);
     GetInteger(pElement, "percentseekbackwardbig", g_advancedSettings.m_videoPercentSeekBackwardBig, -100, 0);
     GetInteger(pElement, "blackbarcolour", g_advancedSettings.m_videoBlackBarColour, 0, 255);
+    GetInteger(pElement, "renderbuffers", g_advancedSettings.m_videoRenderBuffers, 2, 5);
   }
 
   pElement = pRootElement->FirstChildElement("musiclibrary");
@@ -1291,6 +1303,8 @@ void CSettings::LoadAdvancedSettings()
   {
     GetInteger(pElement, "autodetectpingtime", g_advancedSettings.m_autoDetectPingTime, 1, 240);
     GetInteger(pElement, "curlclienttimeout", g_advancedSettings.m_curlclienttimeout, 1, 1000);
+    GetInteger(pElement, "curlcachesize", g_advancedSettings.m_curlcachesize, 0, 1024);
+    GetInteger(pElement, "curlconnections", g_advancedSettings.m_curlconnections, 1, 16);
   }
 
   GetFloat(pRootElement, "playcountminimumpercent", g_advancedSettings.m_playCountMinimumPercent, 1.0f, 100.0f);
@@ -1342,6 +1356,11 @@ void CSettings::LoadAdvancedSettings()
   
   XMLUtils::GetBoolean(pRootElement, "enableviewrestrictions", g_advancedSettings.m_bEnableViewRestrictions);
   XMLUtils::GetBoolean(pRootElement, "enablekeyboardbacklightcontrol", g_advancedSettings.m_bEnableKeyboardBacklightControl);
+  GetInteger(pRootElement, "plexpagesize", g_advancedSettings.m_iPlexPageSize, 0, 5000);
+  GetInteger(pRootElement, "directorycachesize", g_advancedSettings.m_iDirectoryCacheSize, 0, 1048576);
+  GetInteger(pRootElement, "imagecachesize", g_advancedSettings.m_iImageCacheSize, 0, 65536);
+  GetInteger(pRootElement, "imagememorycachesize", g_advancedSettings.m_iImageMemoryCacheSize, 0, 1024);
+  GetInteger(pRootElement, "guiidlerefresh", g_advancedSettings.m_iGUIIdleRefresh, 0, 10000);
   
 
   GetString(pRootElement, "language", g_advancedSettings.m_language);
@@ -2350,6 +2369,7 @@ void CSettings::LoadSkinSettings(const TiXmlElement* pRootElement)
   {
     m_skinStrings.clear();
     m_skinBools.clear();
+    g_infoManager.ResetSkinCache();
     
     const TiXmlElement *pChild = pElement->FirstChildElement("setting");
     while (pChild)
@@ -2463,6 +2483,7 @@ void CSettings::SetSkinString(int setting, const CStdString &label)
   if (it != m_skinStrings.end())
   {
     (*it).second.value = label;
+    g_infoManager.ResetSkinCache();
     return;
   }
   assert(false);
@@ -2479,6 +2500,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = "";
+      g_infoManager.ResetSkinCache();
       return;
     }
   }
@@ -2488,6 +2510,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.ResetSkinCache();
       return;
     }
   }
@@ -2528,6 +2551,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.ResetSkinCache();
     return;
   }
   assert(false);
@@ -2557,6 +2581,7 @@ void CSettings::ResetSkinSettings()
     it2++;
   }
   g_infoManager.ResetCache();
+  g_infoManager.ResetSkinCache();
 }
 
 void CSettings::LoadUserFolderLayout()
@@ -141,6 +141,7 @@ public:
     bool m_DisableModChipDetection;
 
     int m_audioHeadRoom;
+    int m_audioResampleQuality; // 0 low, 1 medium, 2 high
     float m_karaokeSyncDelay;
 
     float m_videoSubsDelayRange;
@@ -167,6 +168,7 @@ public:
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
     int m_videoBlackBarColour;
+    int m_videoRenderBuffers;
 
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
@@ -238,6 +240,8 @@ public:
     bool m_bTuxBoxSendAllAPids;
 
     int m_curlclienttimeout;
+    int m_curlcachesize; // in MB of an http file kept for seeking back, 0 to disable
+    int m_curlconnections; // most connections an http file may be fetched over at once, 1 for one
 
 #ifdef HAS_SDL
     bool m_fullScreen;
@@ -258,6 +262,12 @@ public:
     bool m_bEnableViewRestrictions;
     bool m_bEnableKeyboardBacklightControl;
     
+    int m_iPlexPageSize;
+    int m_iDirectoryCacheSize; // in KB, 0 for no limit
+    int m_iImageCacheSize;     // in MB, 0 for no limit
+    int m_iImageMemoryCacheSize; // in MB of released fanart kept decoded, 0 to free it once released
+    int m_iGUIIdleRefresh;     // in ms between redraws of an unchanged GUI, 0 to redraw every frame
+    
     
     CStdString m_language;
     CStdString m_units;
@@ -31,6 +31,7 @@
 #include "FileSystem/File.h"
 #include "FileItem.h"
 #include "Settings.h"
+#include "PlexImageCache.h"
 
 
 #include "cores/dvdplayer/DVDFileInfo.h"
@@ -116,16 +117,10 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
     CStdString thumb(pItem->GetThumbnailImage());
     if (!CURL::IsFileOnly(thumb) && !CUtil::IsHD(thumb))
     {      
-      if(CFile::Exists(cachedThumb))
-          pItem->SetThumbnailImage(cachedThumb);
+      if (CPlexImageCache::Get()->CacheThumb(thumb, cachedThumb))
+        pItem->SetThumbnailImage(cachedThumb);
       else
-      {
-        CPicture pic;
-        if(pic.DoCreateThumbnail(thumb, cachedThumb))
-          pItem->SetThumbnailImage(cachedThumb);
-        else
-          pItem->SetThumbnailImage("");
-      }
+        pItem->SetThumbnailImage("");
     }  
   }
 
@@ -135,7 +130,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
     
     if (pItem->GetQuickFanart().size() > 0)
     {
-      if (CFile::Exists(pItem->GetCachedPlexMediaServerFanart()))
+      if (CPlexImageCache::Get()->Exists(pItem->GetCachedPlexMediaServerFanart()))
         pItem->SetProperty("fanart_image", pItem->GetCachedPlexMediaServerFanart());
     }
     else
@@ -150,7 +145,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
     pItem->CacheBanner();
     if (pItem->GetQuickBanner().size() > 0)
     {
-      if (CFile::Exists(pItem->GetCachedPlexMediaServerBanner()))
+      if (CPlexImageCache::Get()->Exists(pItem->GetCachedPlexMediaServerBanner()))
         pItem->SetProperty("banner_image", pItem->GetCachedPlexMediaServerBanner());
     }
   }
@@ -166,16 +161,8 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
       string url = pair.second;
       
       string localFile = CFileItem::GetCachedPlexMediaServerThumb(url);
-      if (CFile::Exists(localFile) == false)
-      {
-        CPicture pic;
-        if (pic.DoCreateThumbnail(url, localFile))
-          pItem->SetProperty(name, localFile);
-      }
-      else
-      {
+      if (CPlexImageCache::Get()->CacheThumb(url, localFile))
         pItem->SetProperty(name, localFile);
-      }
     }
   }
   
@@ -248,18 +235,10 @@ bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
     if (!CURL::IsFileOnly(thumb) && !CUtil::IsHD(thumb))
     {
       CStdString cachedThumb(pItem->GetCachedMusicThumb());
-      if(CFile::Exists(cachedThumb))
-      {
+      if (CPlexImageCache::Get()->CacheThumb(thumb, cachedThumb))
         pItem->SetThumbnailImage(cachedThumb);
-      }
       else
-      {
-        CPicture pic;
-        if(pic.DoCreateThumbnail(thumb, cachedThumb))
-          pItem->SetThumbnailImage(cachedThumb);
-        else
-          pItem->SetThumbnailImage("");
-      }
+        pItem->SetThumbnailImage("");
     }  
   }
   
@@ -269,7 +248,7 @@ bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
     
     if (pItem->GetQuickFanart().size() > 0)
     {
-      if (CFile::Exists(pItem->GetCachedPlexMediaServerFanart()))
+      if (CPlexImageCache::Get()->Exists(pItem->GetCachedPlexMediaServerFanart()))
         pItem->SetProperty("fanart_image", pItem->GetCachedPlexMediaServerFanart());
     }
     else
@@ -70,6 +70,7 @@
 #include "utils/AlarmClock.h"
 #include "ButtonTranslator.h"
 #include "Picture.h"
+#include "PlexImageCache.h"
 #include "GUIDialogNumeric.h"
 #include "GUIDialogFileBrowser.h"
 #include "utils/fstrcmp.h"
@@ -447,18 +448,10 @@ void CUtil::AutodetectPlexSources(CStdString strPlexPath, VECSOURCES& dstSources
         CStdString cachedThumb(item->GetCachedPlexMediaServerThumb());
         CStdString thumb(item->GetThumbnailImage());
         
-        if (CFile::Exists(cachedThumb))
-        {
+        if (CPlexImageCache::Get()->CacheThumb(thumb, cachedThumb))
           item->SetThumbnailImage(cachedThumb);
-        }
         else
-        {
-          CPicture pic;
-          if(pic.DoCreateThumbnail(thumb, cachedThumb))
-            item->SetThumbnailImage(cachedThumb);
-          else
-            item->SetThumbnailImage("");
-        }
+          item->SetThumbnailImage("");
         
         share.m_strThumbnailImage = cachedThumb;
 
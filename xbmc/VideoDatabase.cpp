@@ -43,11 +43,18 @@ using namespace XFILE;
 using namespace DIRECTORY;
 using namespace VIDEO;
 
-#define VIDEO_DATABASE_VERSION 22
+#define VIDEO_DATABASE_VERSION 23
 #define VIDEO_DATABASE_OLD_VERSION 3.f
 #define VIDEO_DATABASE_NAME "MyVideos34.db"
 #define RECENTLY_ADDED_LIMIT  g_guiSettings.GetInt("videolibrary.recentcount")
 
+// item types in the search index
+#define SEARCH_MOVIE          1
+#define SEARCH_TVSHOW         2
+#define SEARCH_EPISODE        3
+#define SEARCH_EPISODE_PLOT   4
+#define SEARCH_MUSICVIDEO     5
+
 CBookmark::CBookmark()
 {
   timeInSeconds = 0.0f;
@@ -293,6 +300,8 @@ bool CVideoDatabase::CreateTables()
     CLog::Log(LOGINFO, "create movieview");
     m_pDS->exec("create view movieview as select movie.*,files.strFileName as strFileName,path.strPath as strPath "
                 "from movie join files on files.idFile=movie.idFile join path on path.idPath=files.idPath");
+
+    CreateSearchIndex();
   }
   catch (...)
   {
@@ -303,6 +312,23 @@ bool CVideoDatabase::CreateTables()
   return true;
 }
 
+//********************************************************************************************************************************
+void CVideoDatabase::CreateSearchIndex()
+{
+  CDatabase::CreateSearchIndex();
+
+  // keep it in sync whichever way items get deleted
+  CLog::Log(LOGINFO, "create searchindex triggers");
+  CStdString strSQL = FormatSQL("CREATE TRIGGER tgrSearchMovie AFTER delete ON movie FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idMovie; END", SEARCH_MOVIE);
+  m_pDS->exec(strSQL.c_str());
+  strSQL = FormatSQL("CREATE TRIGGER tgrSearchTvShow AFTER delete ON tvshow FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idShow; END", SEARCH_TVSHOW);
+  m_pDS->exec(strSQL.c_str());
+  strSQL = FormatSQL("CREATE TRIGGER tgrSearchEpisode AFTER delete ON episode FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idEpisode; delete from searchindex where iType=%i and idItem=old.idEpisode; END", SEARCH_EPISODE, SEARCH_EPISODE_PLOT);
+  m_pDS->exec(strSQL.c_str());
+  strSQL = FormatSQL("CREATE TRIGGER tgrSearchMusicVideo AFTER delete ON musicvideo FOR EACH ROW BEGIN delete from searchindex where iType=%i and idItem=old.idMVideo; END", SEARCH_MUSICVIDEO);
+  m_pDS->exec(strSQL.c_str());
+}
+
 //********************************************************************************************************************************
 long CVideoDatabase::GetPathId(const CStdString& strPath)
 {
@@ -1642,6 +1668,8 @@ void CVideoDatabase::SetDetailsForMovie(const CStdString& strFilenameAndPath, co
     CStdString sql = "update movie set " + GetValueString(details, VIDEODB_ID_MIN, VIDEODB_ID_MAX, DbMovieOffsets);
     sql += FormatSQL(" where idMovie=%u", lMovieId);
     m_pDS->exec(sql.c_str());
+
+    SetSearchText(SEARCH_MOVIE, lMovieId, details.m_strTitle);
   }
   catch (...)
   {
@@ -1687,6 +1715,8 @@ long CVideoDatabase::SetDetailsForTvShow(const CStdString& strPath, const CVideo
     CStdString sql = "update tvshow set " + GetValueString(details, VIDEODB_ID_TV_MIN, VIDEODB_ID_TV_MAX, DbTvShowOffsets);
     sql += FormatSQL("where idShow=%u", lTvShowId);
     m_pDS->exec(sql.c_str());
+
+    SetSearchText(SEARCH_TVSHOW, lTvShowId, details.m_strTitle);
     return lTvShowId;
   }
   catch (...)
@@ -1747,6 +1777,9 @@ long CVideoDatabase::SetDetailsForEpisode(const CStdString& strFilenameAndPath,
     CStdString sql = "update episode set " + GetValueString(details, VIDEODB_ID_EPISODE_MIN, VIDEODB_ID_EPISODE_MAX, DbEpisodeOffsets);
     sql += FormatSQL("where idEpisode=%u", lEpisodeId);
     m_pDS->exec(sql.c_str());
+
+    SetSearchText(SEARCH_EPISODE, lEpisodeId, details.m_strTitle);
+    SetSearchText(SEARCH_EPISODE_PLOT, lEpisodeId, details.m_strPlot);
     return lEpisodeId;
   }
   catch (...)
@@ -1814,6 +1847,8 @@ void CVideoDatabase::SetDetailsForMusicVideo(const CStdString& strFilenameAndPat
     CStdString sql = "update musicvideo set " + GetValueString(details, VIDEODB_ID_MUSICVIDEO_MIN, VIDEODB_ID_MUSICVIDEO_MAX, DbMusicVideoOffsets);
     sql += FormatSQL(" where idMVideo=%u", lMVideoId);
     m_pDS->exec(sql.c_str());
+
+    SetSearchText(SEARCH_MUSICVIDEO, lMVideoId, details.m_strTitle);
   }
   catch (...)
   {
@@ -3090,6 +3125,22 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
     }
     if (iVersion < 22) // reverse audio/subtitle offsets
       m_pDS->exec("update settings set SubtitleDelay=-SubtitleDelay and AudioDelay=-AudioDelay");
+    if (iVersion < 23)
+    {
+      // add the search index, and fill it. this is still inside the upgrade's transaction,
+      // so if any of it fails the whole upgrade is rolled back and tried again next time
+      CreateSearchIndex();
+      if (!RebuildSearchIndex(SEARCH_MOVIE, FormatSQL("select idMovie,c%02d from movie", VIDEODB_ID_TITLE)) ||
+          !RebuildSearchIndex(SEARCH_TVSHOW, FormatSQL("select idShow,c%02d from tvshow", VIDEODB_ID_TV_TITLE)) ||
+          !RebuildSearchIndex(SEARCH_EPISODE, FormatSQL("select idEpisode,c%02d from episode", VIDEODB_ID_EPISODE_TITLE)) ||
+          !RebuildSearchIndex(SEARCH_EPISODE_PLOT, FormatSQL("select idEpisode,c%02d from episode", VIDEODB_ID_EPISODE_PLOT)) ||
+          !RebuildSearchIndex(SEARCH_MUSICVIDEO, FormatSQL("select idMVideo,c%02d from musicvideo", VIDEODB_ID_MUSICVIDEO_TITLE)))
+      {
+        CLog::Log(LOGERROR, "Error attempting to build the search index!");
+        RollbackTransaction();
+        return false;
+      }
+    }
   }
   catch (...)
   {
@@ -3152,6 +3203,15 @@ void CVideoDatabase::UpdateMovieTitle(long lMovieId, const CStdString& strNewMov
       strSQL = FormatSQL("UPDATE musicvideo SET c%02d='%s' WHERE idMVideo=%i", VIDEODB_ID_MUSICVIDEO_TITLE, strNewMovieTitle.c_str(), lMovieId );
     }
     m_pDS->exec(strSQL.c_str());
+
+    if (iType == VIDEODB_CONTENT_MOVIES)
+      SetSearchText(SEARCH_MOVIE, lMovieId, strNewMovieTitle);
+    else if (iType == VIDEODB_CONTENT_EPISODES)
+      SetSearchText(SEARCH_EPISODE, lMovieId, strNewMovieTitle);
+    else if (iType == VIDEODB_CONTENT_TVSHOWS)
+      SetSearchText(SEARCH_TVSHOW, lMovieId, strNewMovieTitle);
+    else if (iType == VIDEODB_CONTENT_MUSICVIDEOS)
+      SetSearchText(SEARCH_MUSICVIDEO, lMovieId, strNewMovieTitle);
   }
   catch (...)
   {
@@ -4969,10 +5029,15 @@ void CVideoDatabase::GetMoviesByName(const CStdString& strSearch, CFileItemList&
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    CStdString strHits = GetSearchSQL(SEARCH_MOVIE, strSearch);
+    if (strHits.IsEmpty()) return;
+
     if (g_settings.m_vecProfiles[0].getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = FormatSQL("select movie.idmovie,movie.c%02d,path.strPath from movie,file,path where file.idfile=movie.idfile and file.idPath=path.idPath and movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select movie.idmovie,movie.c%02d,path.strPath from (",VIDEODB_ID_TITLE) + strHits +
+               FormatSQL(") as hits,movie,files,path where movie.idmovie=hits.idItem and files.idfile=movie.idfile and files.idPath=path.idPath order by hits.exact desc,hits.pos,movie.c%02d",VIDEODB_ID_TITLE);
     else
-      strSQL = FormatSQL("select movie.idmovie,movie.c%02d from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select movie.idmovie,movie.c%02d from (",VIDEODB_ID_TITLE) + strHits +
+               FormatSQL(") as hits,movie where movie.idmovie=hits.idItem order by hits.exact desc,hits.pos,movie.c%02d",VIDEODB_ID_TITLE);
     m_pDS->query( strSQL.c_str() );
 
     while (!m_pDS->eof())
@@ -5010,10 +5075,15 @@ void CVideoDatabase::GetTvShowsByName(const CStdString& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    CStdString strHits = GetSearchSQL(SEARCH_TVSHOW, strSearch);
+    if (strHits.IsEmpty()) return;
+
     if (g_settings.m_vecProfiles[0].getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = FormatSQL("select tvshow.idshow,tvshow.c%02d,path.strPath from tvshow,path,tvshowlinkpath where tvshowlinkpath.idpath=path.idpath and tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select tvshow.idshow,tvshow.c%02d,path.strPath from (",VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,tvshow,path,tvshowlinkpath where tvshow.idshow=hits.idItem and tvshowlinkpath.idshow=tvshow.idshow and tvshowlinkpath.idpath=path.idpath order by hits.exact desc,hits.pos,tvshow.c%02d",VIDEODB_ID_TV_TITLE);
     else
-      strSQL = FormatSQL("select tvshow.idshow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select tvshow.idshow,tvshow.c%02d from (",VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,tvshow where tvshow.idshow=hits.idItem order by hits.exact desc,hits.pos,tvshow.c%02d",VIDEODB_ID_TV_TITLE);
     m_pDS->query( strSQL.c_str() );
 
     while (!m_pDS->eof())
@@ -5051,10 +5121,15 @@ void CVideoDatabase::GetEpisodesByName(const CStdString& strSearch, CFileItemLis
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    CStdString strHits = GetSearchSQL(SEARCH_EPISODE, strSearch);
+    if (strHits.IsEmpty()) return;
+
     if (g_settings.m_vecProfiles[0].getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d,path.strPath from episode,file,path,tvshowlinkepisode,tvshow where file.idfile=episode.idfile and tvshowlinkepisode.idepisode=episode.idepisode and tvshowlinkepisode.idshow=tvshow.idshow and file.idPath=path.idPath and episode.c%02d like '%%%s%%'",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE,VIDEODB_ID_EPISODE_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d,path.strPath from (",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,episode,files,path,tvshowlinkepisode,tvshow where episode.idepisode=hits.idItem and files.idfile=episode.idfile and tvshowlinkepisode.idepisode=episode.idepisode and tvshowlinkepisode.idshow=tvshow.idshow and files.idPath=path.idPath order by hits.exact desc,hits.pos,episode.c%02d",VIDEODB_ID_EPISODE_TITLE);
     else
-      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d from episode,tvshowlinkepisode,tvshow where tvshowlinkepisode.idepisode=episode.idepisode and tvshow.idshow=tvshowlinkepisode.idshow and episode.c%02d like '%%%s%%'",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE,VIDEODB_ID_EPISODE_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d from (",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,episode,tvshowlinkepisode,tvshow where episode.idepisode=hits.idItem and tvshowlinkepisode.idepisode=episode.idepisode and tvshow.idshow=tvshowlinkepisode.idshow order by hits.exact desc,hits.pos,episode.c%02d",VIDEODB_ID_EPISODE_TITLE);
     m_pDS->query( strSQL.c_str() );
 
     while (!m_pDS->eof())
@@ -5093,10 +5168,15 @@ void CVideoDatabase::GetMusicVideosByName(const CStdString& strSearch, CFileItem
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    CStdString strHits = GetSearchSQL(SEARCH_MUSICVIDEO, strSearch);
+    if (strHits.IsEmpty()) return;
+
     if (g_settings.m_vecProfiles[0].getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = FormatSQL("select musicvideo.idmvideo,musicvideo.c%02d,path.strPath from musicvideo,file,path where file.idfile=musicvideo.idfile and file.idPath=path.idPath and musicvideo.%c02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select musicvideo.idmvideo,musicvideo.c%02d,path.strPath from (",VIDEODB_ID_MUSICVIDEO_TITLE) + strHits +
+               FormatSQL(") as hits,musicvideo,files,path where musicvideo.idmvideo=hits.idItem and files.idfile=musicvideo.idfile and files.idPath=path.idPath order by hits.exact desc,hits.pos,musicvideo.c%02d",VIDEODB_ID_MUSICVIDEO_TITLE);
     else
-      strSQL = FormatSQL("select musicvideo.idmvideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = FormatSQL("select musicvideo.idmvideo,musicvideo.c%02d from (",VIDEODB_ID_MUSICVIDEO_TITLE) + strHits +
+               FormatSQL(") as hits,musicvideo where musicvideo.idmvideo=hits.idItem order by hits.exact desc,hits.pos,musicvideo.c%02d",VIDEODB_ID_MUSICVIDEO_TITLE);
     m_pDS->query( strSQL.c_str() );
 
     while (!m_pDS->eof())
@@ -5140,10 +5220,15 @@ void CVideoDatabase::GetEpisodesByPlot(const CStdString& strSearch, CFileItemLis
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    CStdString strHits = GetSearchSQL(SEARCH_EPISODE_PLOT, strSearch);
+    if (strHits.IsEmpty()) return;
+
     if (g_settings.m_vecProfiles[0].getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode,c%02d,tvshowlinkepisode.idshow,tvshow.c%02d,path.strPath from episode,file,path,tvshowlinkepisode,tvshow where file.idepisode=episode.idepisode and tvshowlinkepisode.idepisode=episode.idepisode and file.idPath=path.idPath and tvshow.idshow=tvshowlinkepisode.idshow and episode.c%02d like '%%%s%%'",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE,VIDEODB_ID_EPISODE_PLOT,strSearch.c_str());
+      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d,path.strPath from (",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,episode,files,path,tvshowlinkepisode,tvshow where episode.idepisode=hits.idItem and files.idfile=episode.idfile and tvshowlinkepisode.idepisode=episode.idepisode and tvshowlinkepisode.idshow=tvshow.idshow and files.idPath=path.idPath order by hits.exact desc,hits.pos,episode.c%02d",VIDEODB_ID_EPISODE_TITLE);
     else
-      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d from episode,tvshowlinkepisode,tvshow where tvshowlinkepisode.idepisode=episode.idepisode and tvshow.idshow=tvshowlinkepisode.idshow and episode.c%02d like '%%%s%%'",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE,VIDEODB_ID_EPISODE_PLOT,strSearch.c_str());
+      strSQL = FormatSQL("select episode.idepisode,episode.c%02d,episode.c%02d,tvshowlinkepisode.idshow,tvshow.c%02d from (",VIDEODB_ID_EPISODE_TITLE,VIDEODB_ID_EPISODE_SEASON,VIDEODB_ID_TV_TITLE) + strHits +
+               FormatSQL(") as hits,episode,tvshowlinkepisode,tvshow where episode.idepisode=hits.idItem and tvshowlinkepisode.idepisode=episode.idepisode and tvshow.idshow=tvshowlinkepisode.idshow order by hits.exact desc,hits.pos,episode.c%02d",VIDEODB_ID_EPISODE_TITLE);
     m_pDS->query( strSQL.c_str() );
 
     while (!m_pDS->eof())
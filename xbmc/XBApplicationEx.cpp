@@ -21,6 +21,7 @@
 #define MEASURE_FUNCTION
 #endif
 #include "GUIFontManager.h"
+#include "GUIWindowManager.h"
 #ifdef HAS_SDL_JOYSTICK
 #include "common/SDLJoystick.h"
 #endif
@@ -357,6 +358,11 @@ void CXBApplicationEx::ReadInput()
       g_Mouse.SetResolution(g_settings.m_ResInfo[WINDOW].iWidth, g_settings.m_ResInfo[WINDOW].iHeight, 1, 1);
       g_fontManager.ReloadTTFFonts();
 #endif
+      m_gWindowManager.MarkDirty();
+      break;
+
+    case SDL_VIDEOEXPOSE:
+      m_gWindowManager.MarkDirty();
       break;
 
 #ifdef HAS_SDL_JOYSTICK
@@ -387,6 +393,7 @@ void CXBApplicationEx::ReadInput()
       {
         m_AppActive = event.active.gain != 0;
       }
+      m_gWindowManager.MarkDirty();
       break;
     case SDL_MOUSEBUTTONDOWN:
       // mouse scroll wheel.
@@ -0,0 +1,360 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "Resampler.h"
+#include "utils/CPUInfo.h"
+#include <math.h>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define MAX_PHASES        1024  // 44.1k <-> 48k needs 160, 11.025k -> 48k 640
+#define MAX_INPUT_SAMPLES 2048  // asked for at a time, so a packet from the decoder always does
+
+// taps per phase when not downsampling, the kaiser window's beta and the cutoff as part of nyquist
+struct ResamplerQuality
+{
+  int    taps;
+  double beta;
+  double cutoff;
+};
+
+static const ResamplerQuality qualities[] =
+{
+  { 16, 6.0,  0.80 },  // QUALITY_LOW
+  { 32, 8.0,  0.88 },  // QUALITY_MEDIUM
+  { 64, 10.0, 0.92 },  // QUALITY_HIGH
+};
+
+static int gcd(int a, int b)
+{
+  while (b)
+  {
+    int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+static double BesselI0(double x)
+{
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 50; k++)
+  {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+static float Dot_C(const float *x, const float *h, int taps)
+{
+  float sum = 0.0f;
+  for (int k = 0; k < taps; k++)
+    sum += x[k] * h[k];
+  return sum;
+}
+
+static void FloatToS16_C(const float *in, short *out, int i, int count)
+{
+  for (; i < count; i++)
+  {
+    float result = floorf(32767.0f * in[i] + 0.5f);
+    if (result > 32767.0f)
+      out[i] = 32767;
+    else if (result < -32768.0f)
+      out[i] = -32768;
+    else
+      out[i] = (short)result;
+  }
+}
+
+#ifdef __SSE2__
+// taps is a multiple of 8, h is aligned
+static float Dot_SSE2(const float *x, const float *h, int taps)
+{
+  __m128 a0 = _mm_setzero_ps();
+  __m128 a1 = _mm_setzero_ps();
+  for (int k = 0; k < taps; k += 8)
+  {
+    a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(x + k),     _mm_load_ps(h + k)));
+    a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(x + k + 4), _mm_load_ps(h + k + 4)));
+  }
+  a0 = _mm_add_ps(a0, a1);
+  a0 = _mm_add_ps(a0, _mm_movehl_ps(a0, a0));
+  a0 = _mm_add_ss(a0, _mm_shuffle_ps(a0, a0, 1));
+  return _mm_cvtss_f32(a0);
+}
+
+// 8 samples at a time, returns how many were done
+static int FloatToS16_SSE2(const float *in, short *out, int count)
+{
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  const __m128 hi    = _mm_set1_ps(32767.0f);
+  const __m128 lo    = _mm_set1_ps(-32768.0f);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i),     scale), lo), hi);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), lo), hi);
+    _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+  }
+  return i;
+}
+#endif
+
+CResampler::CResampler()
+{
+  m_filter = NULL;
+  m_filterMem = NULL;
+  DeInitialize();
+}
+
+CResampler::~CResampler()
+{
+  DeInitialize();
+}
+
+void CResampler::DeInitialize()
+{
+  delete[] m_filterMem;
+  m_filterMem = NULL;
+  m_filter = NULL;
+
+  m_channels = 0;
+  m_packetSamples = 0;
+  m_passThrough = true;
+  m_up = m_down = 1;
+  m_step = 1;
+  m_stepFrac = 0;
+  m_phases = 1;
+  m_taps = 0;
+  m_pos = 0;
+  m_frac = 0;
+  m_input.clear();
+  m_output.clear();
+  m_outputLen = 0;
+  m_sse2 = false;
+  m_dot = Dot_C;
+}
+
+bool CResampler::InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize,
+                               Quality quality)
+{
+  DeInitialize();
+
+  if (OldFreq <= 0 || NewFreq <= 0 || Channels <= 0 || NewBPS != 16 || OutputBufferSize < 2 * Channels)
+    return false;
+
+  if (quality < QUALITY_LOW || quality > QUALITY_HIGH)
+    quality = QUALITY_MEDIUM;
+
+  m_channels = Channels;
+  m_packetSamples = OutputBufferSize / 2;
+  m_output.resize(m_packetSamples * 2);
+#ifdef __SSE2__
+  m_sse2 = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+  if (m_sse2)
+    m_dot = Dot_SSE2;
+#endif
+
+  m_passThrough = OldFreq == NewFreq;
+  if (m_passThrough)
+    return true;
+
+  int div = gcd(OldFreq, NewFreq);
+  m_up     = NewFreq / div;
+  m_down   = OldFreq / div;
+  m_step   = m_down / m_up;
+  m_stepFrac = m_down % m_up;
+  m_phases = std::min(m_up, MAX_PHASES);
+
+  // when downsampling the filter has to be as much longer as its cutoff is lower
+  const ResamplerQuality& q = qualities[quality];
+  double scale = std::min(1.0, (double)m_up / m_down);
+  m_taps = (int)ceil(q.taps / scale);
+  m_taps = (m_taps + 7) & ~7;
+
+  MakeFilter(0.5 * q.cutoff * scale, q.beta);
+
+  // start with half the filter in silence, so the first output lines up with the first input
+  m_input.resize(m_channels);
+  for (int c = 0; c < m_channels; c++)
+    m_input[c].assign(m_taps / 2 - 1, 0.0f);
+
+  CLog::Log(LOGDEBUG, "CResampler::InitConverter - %i to %i Hz, %i channels, %i phases of %i taps%s",
+            OldFreq, NewFreq, Channels, m_phases, m_taps, m_sse2 ? " (sse2)" : "");
+  return true;
+}
+
+void CResampler::MakeFilter(double cutoff, double beta)
+{
+  m_filterMem = new float[m_phases * m_taps + 4];
+  m_filter = (float *)(((size_t)m_filterMem + 15) & ~(size_t)15);
+
+  // phase p is the sinc shifted by p / m_phases of an input sample. tap k of it is
+  // multiplied by the k'th input sample of the window, which is centred between taps
+  // m_taps / 2 - 1 and m_taps / 2.
+  double i0beta = BesselI0(beta);
+  for (int p = 0; p < m_phases; p++)
+  {
+    float *row = m_filter + p * m_taps;
+    double sum = 0.0;
+    for (int k = 0; k < m_taps; k++)
+    {
+      double t = (double)p / m_phases + m_taps / 2 - 1 - k;
+      double u = t / (m_taps / 2);
+      double window = fabs(u) < 1.0 ? BesselI0(beta * sqrt(1.0 - u * u)) / i0beta : 0.0;
+      double x = 2.0 * M_PI * cutoff * t;
+      double sinc = fabs(x) < 1e-9 ? 1.0 : sin(x) / x;
+      row[k] = (float)(sinc * window);
+      sum += row[k];
+    }
+
+    // unity gain for every phase, so there's no ripple at dc
+    for (int k = 0; k < m_taps; k++)
+      row[k] = (float)(row[k] / sum);
+  }
+}
+
+bool CResampler::GetData(unsigned char *pOutData)
+{
+  if (m_outputLen < m_packetSamples)
+    return false;
+
+  short *out = (short *)pOutData;
+  int i = 0;
+#ifdef __SSE2__
+  if (m_sse2)
+    i = FloatToS16_SSE2(&m_output[0], out, m_packetSamples);
+#endif
+  FloatToS16_C(&m_output[0], out, i, m_packetSamples);
+
+  Consume(m_packetSamples);
+  return true;
+}
+
+int CResampler::GetFloatData(float *pOutData, int numSamples)
+{
+  if (numSamples > m_outputLen)
+    numSamples = m_outputLen;
+
+  memcpy(pOutData, &m_output[0], numSamples * sizeof(float));
+  Consume(numSamples);
+  return numSamples;
+}
+
+void CResampler::Consume(int numSamples)
+{
+  m_outputLen -= numSamples;
+  if (m_outputLen)
+    memmove(&m_output[0], &m_output[numSamples], m_outputLen * sizeof(float));
+}
+
+int CResampler::GetInputSamples()
+{
+  if (!m_channels || m_outputLen >= m_packetSamples)
+    return 0;
+
+  int frames = (m_packetSamples - m_outputLen + m_channels - 1) / m_channels;
+  if (!m_passThrough)
+  {
+    // the last of those frames needs the input up to the end of its filter
+    __int64 last = m_pos + ((__int64)m_frac + (__int64)(frames - 1) * m_down) / m_up + m_taps;
+    frames = (int)(last - (__int64)m_input[0].size());
+  }
+
+  if (frames > MAX_INPUT_SAMPLES / m_channels)
+    frames = MAX_INPUT_SAMPLES / m_channels;
+  if (frames < 1)
+    frames = 1;
+  return frames * m_channels;
+}
+
+int CResampler::PutFloatData(float *pInData, int numSamples)
+{
+  if (!m_channels || !pInData || numSamples <= 0)
+    return 0;
+
+  numSamples -= numSamples % m_channels;
+  int frames = numSamples / m_channels;
+
+  if (m_passThrough)
+  {
+    if (m_outputLen + numSamples > (int)m_output.size())
+      m_output.resize(m_outputLen + numSamples);
+    memcpy(&m_output[m_outputLen], pInData, numSamples * sizeof(float));
+    m_outputLen += numSamples;
+    return numSamples;
+  }
+
+  for (int c = 0; c < m_channels; c++)
+  {
+    std::vector<float>& input = m_input[c];
+    size_t size = input.size();
+    input.resize(size + frames);
+    for (int i = 0; i < frames; i++)
+      input[size + i] = pInData[i * m_channels + c];
+  }
+
+  Resample();
+  return numSamples;
+}
+
+void CResampler::Resample()
+{
+  int available = (int)m_input[0].size();
+  while (m_pos + m_taps <= available)
+  {
+    if (m_outputLen + m_channels > (int)m_output.size())
+      m_output.resize(m_output.size() * 2 + m_channels);
+
+    const float *h = m_filter + (m_phases == m_up ? m_frac : (int)((__int64)m_frac * m_phases / m_up)) * m_taps;
+    float *out = &m_output[m_outputLen];
+    for (int c = 0; c < m_channels; c++)
+      out[c] = m_dot(&m_input[c][m_pos], h, m_taps);
+    m_outputLen += m_channels;
+
+    m_pos  += m_step;
+    m_frac += m_stepFrac;
+    if (m_frac >= m_up)
+    {
+      m_frac -= m_up;
+      m_pos++;
+    }
+  }
+
+  // drop what no output needs any more
+  int used = std::min(m_pos, available);
+  if (used > 0)
+  {
+    for (int c = 0; c < m_channels; c++)
+      m_input[c].erase(m_input[c].begin(), m_input[c].begin() + used);
+    m_pos -= used;
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <vector>
+
+// Sample rate conversion with a polyphase filter, a windowed sinc which is worked out once
+// for every phase the rates need. Each output sample is then just one dot product per
+// channel, done with SSE2 where the CPU has it. That code is only built when the compiler
+// targets SSE2 (__SSE2__, always so on x86_64); other builds only have the plain C one.
+//
+// It is called the same way as Cssrc: float samples go in with PutFloatData, as the
+// codecs give them, and packets of 16 bit samples come out of GetData.
+class CResampler
+{
+public:
+  enum Quality
+  {
+    QUALITY_LOW = 0,
+    QUALITY_MEDIUM,
+    QUALITY_HIGH
+  };
+
+  CResampler();
+  ~CResampler();
+
+  // OldBPS is only there to match Cssrc, the input is always float. NewBPS has to be 16.
+  bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize,
+                     Quality quality = QUALITY_MEDIUM);
+  void DeInitialize();
+
+  // takes a packet of OutputBufferSize bytes out, returns false if there isn't one yet
+  bool GetData(unsigned char *pOutData);
+
+  // or up to numSamples float samples, returns how many there were
+  int GetFloatData(float *pOutData, int numSamples);
+
+  // how many samples we'd like next to make up the packet, 0 if GetData has to be called first
+  int GetInputSamples();
+
+  // takes all the samples given, returns how many that was
+  int PutFloatData(float *pInData, int numSamples);
+
+private:
+  typedef float (*DotFunc)(const float *x, const float *h, int taps);
+
+  void MakeFilter(double cutoff, double beta);
+  void Resample();
+  void Consume(int numSamples);
+
+  int m_channels;
+  int m_packetSamples;
+  bool m_passThrough;
+
+  // the output rate is m_up / m_down times the input rate. one output sample
+  // moves m_step whole input samples and m_stepFrac / m_up further.
+  int m_up;
+  int m_down;
+  int m_step;
+  int m_stepFrac;
+  int m_phases;  // m_up, or fewer if there would be too many. then the nearest one is used
+
+  int m_taps;    // per phase, a multiple of 8
+  float *m_filter;  // m_phases rows of m_taps, each 16 byte aligned
+  float *m_filterMem;
+
+  std::vector< std::vector<float> > m_input;  // per channel, from the first sample still needed
+  int m_pos;     // of the next output's first tap in m_input
+  int m_frac;    // and the phase it's at, out of m_up
+
+  std::vector<float> m_output;  // interleaved, waiting to be taken out
+  int m_outputLen;
+
+  bool m_sse2;
+  DotFunc m_dot;
+};
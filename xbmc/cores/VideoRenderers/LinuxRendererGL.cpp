@@ -28,6 +28,8 @@
 #include "../../Util.h"
 #include "../../Settings.h"
 #include "../../XBVideoConfig.h"
+#include "../../utils/PixelConverter.h"
+#include "../dvdplayer/DVDPerformanceCounter.h"
 #include "../../../guilib/Surface.h"
 #include "../../../guilib/FrameBufferObject.h"
 
@@ -77,10 +79,17 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_isSoftwareUpscaling = false;
 
   memset(m_image, 0, sizeof(m_image));
+  memset(m_imageRef, 0, sizeof(m_imageRef));
+  memset(m_pbo, 0, sizeof(m_pbo));
+  memset(m_pboMapped, 0, sizeof(m_pboMapped));
+  memset(m_fence, 0, sizeof(m_fence));
+  m_fenceType = FENCE_NONE;
+  memset(m_uploaded, 0, sizeof(m_uploaded));
   memset(m_YUVTexture, 0, sizeof(m_YUVTexture));
 
   m_rgbBuffer = NULL;
   m_rgbBufferSize = 0;
+  m_rgbSource = NULL;
   m_bRGBImageSet = false;
 }
 
@@ -506,7 +515,6 @@ void CLinuxRendererGL::CalcNormalDisplayRect(float fOffsetX1, float fOffsetY1, f
 
 void CLinuxRendererGL::ManageTextures()
 {
-  m_NumYV12Buffers = 2;
   m_NumOSDBuffers = 1;
   //m_iYV12RenderBuffer = 0;
   m_iOSDRenderBuffer = 0;
@@ -556,6 +564,28 @@ bool CLinuxRendererGL::ValidateRenderTarget()
 
      // create the yuv textures    
     LoadShaders();
+
+    // with pixel buffers, a third image means the next one to be written has always been
+    // mapped already, instead of only once the render thread has uploaded the last one.
+    // more give the uploads longer to finish before their buffers are needed again.
+    if (UsePBO())
+    {
+      m_NumYV12Buffers = g_advancedSettings.m_videoRenderBuffers;
+      if (m_NumYV12Buffers > NUM_BUFFERS)
+        m_NumYV12Buffers = NUM_BUFFERS;
+
+      if (glewIsSupported("GL_APPLE_fence"))
+        m_fenceType = FENCE_APPLE;
+      else if (glewIsSupported("GL_NV_fence"))
+        m_fenceType = FENCE_NV;
+      else
+        m_fenceType = FENCE_NONE;
+
+      CLog::Log(LOGDEBUG, "GL: Using %d pixel buffered images, %s", m_NumYV12Buffers,
+                m_fenceType == FENCE_NONE ? "no fences" : "fenced");
+    }
+    else
+      m_NumYV12Buffers = 2;
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
     {
       CreateYV12Texture(i);
@@ -569,6 +599,7 @@ bool CLinuxRendererGL::ValidateRenderTarget()
 void CLinuxRendererGL::SetRGB32Image(const char *image, int nHeight, int nWidth, int nPitch)
 {
   CSingleLock lock(g_graphicsContext);
+  m_rgbSource = NULL;
   if (m_rgbBuffer == NULL)
   {
     m_rgbBufferSize = nWidth*nHeight*4;
@@ -598,6 +629,38 @@ void CLinuxRendererGL::SetRGB32Image(const char *image, int nHeight, int nWidth,
   }
 }
 
+// Same as SetRGB32Image, but without the copy: the image is uploaded from where it is until another
+// one is set, so the caller has to keep it intact until then. Passing NULL takes a copy of the
+// current image and lets go of it.
+void CLinuxRendererGL::SetRGB32ImageRef(const char *image, int nHeight, int nWidth, int nPitch)
+{
+  CSingleLock lock(g_graphicsContext);
+  if (image == NULL)
+  {
+    if (m_rgbSource && m_rgbBuffer)
+      memcpy(m_rgbBuffer, m_rgbSource, m_rgbBufferSize);
+    m_rgbSource = NULL;
+    return;
+  }
+
+  // only tightly packed images of the configured size can be uploaded in place
+  if (m_rgbBuffer == NULL || nPitch != nWidth * 4 || nHeight * nWidth * 4 != m_rgbBufferSize)
+  {
+    SetRGB32Image(image, nHeight, nWidth, nPitch);
+    return;
+  }
+
+  m_rgbSource = (const BYTE *)image;
+  m_bRGBImageSet = true;
+  m_renderMethod = RENDER_SW;
+
+  if (m_pYUVShader)
+  {
+    delete m_pYUVShader;
+    m_pYUVShader = NULL;
+  }
+}
+
 bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags)
 {
   m_fps = fps;
@@ -623,6 +686,7 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
      m_rgbBuffer = NULL;
   }
 
+  m_rgbSource = NULL;
   m_rgbBufferSize = width*height*4;
   m_rgbBuffer = new BYTE[m_rgbBufferSize];
   memset(m_rgbBuffer, 0, m_rgbBufferSize);
@@ -738,6 +802,10 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
   if( source == AUTOSOURCE )
     source = NextYV12Texture();
 
+  // still being uploaded, the render thread maps it again afterwards
+  if (m_pbo[source][0] && !m_pboMapped[source] && !m_imageRef[source])
+    return -1;
+
   if (!m_image[source].plane[0])
   {
      CLog::Log(LOGDEBUG, "CLinuxRenderer::GetImage - image planes not allocated");
@@ -759,6 +827,7 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
       if( WaitForSingleObject(m_eventTexturesDone[source], 500) == WAIT_TIMEOUT )
         CLog::Log(LOGWARNING, "%s - Timeout waiting for texture %d", __FUNCTION__, source);
 
+      ReleaseImageRef(source);
       m_image[source].flags |= IMAGE_FLAG_WRITING;
     }
 
@@ -782,10 +851,142 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
   return -1;
 }
 
+bool CLinuxRendererGL::SetImageRef(int source, CDVDVideoBuffer *buffer, BYTE *plane[], int stride[])
+{
+  YV12Image &im = m_image[source];
+  if (!(im.flags & IMAGE_FLAG_WRITING) || !im.plane[0])
+    return false;
+
+  ReleaseImageRef(source);
+
+  buffer->Acquire();
+  m_imageRef[source] = buffer;
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    m_imagePlanes[source][p] = im.plane[p];
+    m_imageStrides[source][p] = im.stride[p];
+    im.plane[p] = plane[p];
+    im.stride[p] = stride[p];
+  }
+
+  return true;
+}
+
+void CLinuxRendererGL::ReleaseImageRef(int source)
+{
+  if (!m_imageRef[source])
+    return;
+
+  YV12Image &im = m_image[source];
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    im.plane[p] = m_imagePlanes[source][p];
+    im.stride[p] = m_imageStrides[source][p];
+  }
+
+  m_imageRef[source]->Release();
+  m_imageRef[source] = NULL;
+}
+
+bool CLinuxRendererGL::UsePBO()
+{
+  // pictures which are converted or scaled in software have to stay in client memory
+  return glewIsSupported("GL_ARB_pixel_buffer_object") && !(m_renderMethod & RENDER_SW) &&
+         !IsSoftwareUpscaling() && !(m_iFlags & CONF_FLAGS_RGB);
+}
+
+bool CLinuxRendererGL::MapPBO(int index, bool orphan)
+{
+  YV12Image &im = m_image[index];
+  unsigned size[MAX_PLANES] = { im.stride[0] * im.height,
+                                im.stride[1] * (im.height >> 1),
+                                im.stride[2] * (im.height >> 1) };
+
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[index][p]);
+    // orphan the old storage rather than wait for the upload from it to finish,
+    // unless a fence has told us that it has
+    if (orphan)
+      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size[p], NULL, GL_STREAM_DRAW_ARB);
+    im.plane[p] = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+  }
+  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+  m_pboMapped[index] = true;
+  if (!im.plane[0] || !im.plane[1] || !im.plane[2])
+  {
+    UnmapPBO(index);
+    return false;
+  }
+  return true;
+}
+
+void CLinuxRendererGL::UnmapPBO(int index)
+{
+  if (!m_pboMapped[index])
+    return;
+
+  YV12Image &im = m_image[index];
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[index][p]);
+    if (im.plane[p])
+      glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+    im.plane[p] = NULL;
+  }
+  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+  m_pboMapped[index] = false;
+}
+
+void CLinuxRendererGL::SetFence(int index)
+{
+  if (m_fenceType == FENCE_APPLE)
+  {
+    if (!m_fence[index])
+      glGenFencesAPPLE(1, &m_fence[index]);
+    glSetFenceAPPLE(m_fence[index]);
+  }
+  else if (m_fenceType == FENCE_NV)
+  {
+    if (!m_fence[index])
+      glGenFencesNV(1, &m_fence[index]);
+    glSetFenceNV(m_fence[index], GL_ALL_COMPLETED_NV);
+  }
+}
+
+bool CLinuxRendererGL::FenceDone(int index)
+{
+  if (!m_fence[index])
+    return true;
+
+  if (m_fenceType == FENCE_APPLE)
+    return glTestFenceAPPLE(m_fence[index]) == GL_TRUE;
+  else if (m_fenceType == FENCE_NV)
+    return glTestFenceNV(m_fence[index]) == GL_TRUE;
+  return true;
+}
+
+void CLinuxRendererGL::DeleteFence(int index)
+{
+  if (!m_fence[index])
+    return;
+
+  if (m_fenceType == FENCE_APPLE)
+    glDeleteFencesAPPLE(1, &m_fence[index]);
+  else if (m_fenceType == FENCE_NV)
+    glDeleteFencesNV(1, &m_fence[index]);
+  m_fence[index] = 0;
+}
+
 void CLinuxRendererGL::ReleaseImage(int source, bool preserve)
 {
   if( m_image[source].flags & IMAGE_FLAG_WRITING )
+  {
+    m_uploaded[source].valid = false;
     SetEvent(m_eventTexturesDone[source]);
+  }
 
   m_image[source].flags &= ~IMAGE_FLAG_INUSE;
   m_image[source].flags |= IMAGE_FLAG_READY;
@@ -808,15 +1009,57 @@ void CLinuxRendererGL::LoadTextures(int source)
     return;
   }
 
-  // See if we need to recreate textures.
-  if (m_isSoftwareUpscaling != IsSoftwareUpscaling())
+  // See if we need to recreate textures. Software scaling and conversion read the planes
+  // back, which they can't once they've gone off in pixel buffers, so those are dropped too.
+  if (m_isSoftwareUpscaling != IsSoftwareUpscaling() ||
+      (m_pbo[source][0] && !m_bRGBImageSet && (m_renderMethod & RENDER_SW)))
   {
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
-      CreateYV12Texture(i);
+      CreateYV12Texture(i, m_pbo[i][0] != 0);
     
     im->flags = IMAGE_FLAG_READY;
   }
-  
+
+  bool deinterlacing;
+  if (m_currentField == FIELD_FULL)
+  {
+    deinterlacing = false;
+  }
+  else
+  {
+    // FIXME: we need a better/more efficient way to detect deinterlacing?
+    deinterlacing = (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_RENDER_BOB ||
+                     (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_RENDER_BOB_INVERTED) ||
+                     (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_AUTO)) && (m_renderQuality != RQ_MULTIPASS);
+  }
+
+  // the GUI renders far more often than new pictures arrive, only load the textures if they changed.
+  // once its pixel buffers have been handed back the picture only lives on in the textures.
+  SUploaded &uploaded = m_uploaded[source];
+  bool changed = uploaded.deinterlacing != deinterlacing ||
+                 uploaded.brightness != g_stSettings.m_currentVideoSettings.m_Brightness ||
+                 uploaded.contrast != g_stSettings.m_currentVideoSettings.m_Contrast;
+  bool discarded = m_pbo[source][0] && m_pboMapped[source] && !m_imageRef[source];
+  if (!m_bRGBImageSet && uploaded.valid && (!changed || discarded))
+  {
+    SetEvent(m_eventTexturesDone[source]);
+    return;
+  }
+
+  LARGE_INTEGER start;
+  QueryPerformanceCounter(&start);
+
+  // upload from the pixel buffers, this returns straight away and the copy happens in the background
+  bool usePBO = m_pbo[source][0] && !m_imageRef[source] && !m_bRGBImageSet && !IsSoftwareUpscaling();
+  BYTE *planes[MAX_PLANES] = { im->plane[0], im->plane[1], im->plane[2] };
+  if (usePBO)
+  {
+    if (m_pboMapped[source])
+      UnmapPBO(source);
+    // the planes are offsets into the bound buffer now
+    planes[0] = planes[1] = planes[2] = NULL;
+  }
+
   if (IsSoftwareUpscaling() && !m_bRGBImageSet)
   {
     // Perform the scaling.
@@ -849,21 +1092,20 @@ void CLinuxRendererGL::LoadTextures(int source)
     m_renderMethod = RENDER_SW;
   }
 
+  // without shaders the picture is converted to rgb here
+  unsigned rgbStride = im->stride[0];
+  if ((m_renderMethod & RENDER_SW) && !m_bRGBImageSet && im->plane[0] &&
+      (int)(im->width * im->height * 4) <= m_rgbBufferSize)
+  {
+    int stride[] = { im->stride[0], im->stride[1], im->stride[2] };
+    CPixelConverter::YV12ToRGB32(im->plane, stride, im->width, im->height, m_rgbBuffer, im->width * 4,
+                                 CONF_FLAGS_YUVCOEF_MASK(m_iFlags) == CONF_FLAGS_YUVCOEF_BT709);
+    rgbStride = im->width;
+  }
+
   static int imaging = -1;
   static GLfloat brightness = 0;
   static GLfloat contrast   = 0;
-  bool deinterlacing;
-  if (m_currentField == FIELD_FULL)
-  {
-    deinterlacing = false;
-  }
-  else
-  {
-    // FIXME: we need a better/more efficient way to detect deinterlacing?
-    deinterlacing = (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_RENDER_BOB ||
-                     (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_RENDER_BOB_INVERTED) ||
-                     (g_stSettings.m_currentVideoSettings.m_InterlaceMethod==VS_INTERLACEMETHOD_AUTO)) && (m_renderQuality != RQ_MULTIPASS);
-  }
 
   brightness =  ((GLfloat)g_stSettings.m_currentVideoSettings.m_Brightness - 50.0)/100.0;
   contrast =  ((GLfloat)g_stSettings.m_currentVideoSettings.m_Contrast)/50.0;
@@ -911,14 +1153,15 @@ void CLinuxRendererGL::LoadTextures(int source)
   if (m_renderMethod & RENDER_SW)
   {
     // Load RGB image
+    const BYTE *rgb = m_rgbSource ? m_rgbSource : m_rgbBuffer;
     if (deinterlacing)
     {
-      glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[0]*2);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, rgbStride*2);
       glBindTexture(m_textureTarget, fields[FIELD_ODD][0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_BGRA, GL_UNSIGNED_BYTE, m_rgbBuffer);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_BGRA, GL_UNSIGNED_BYTE, rgb);
       glBindTexture(m_textureTarget, fields[FIELD_EVEN][0]);
-      glPixelStorei(GL_UNPACK_SKIP_PIXELS, im->stride[0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_BGRA, GL_UNSIGNED_BYTE, m_rgbBuffer);
+      glPixelStorei(GL_UNPACK_SKIP_PIXELS, rgbStride);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_BGRA, GL_UNSIGNED_BYTE, rgb);
 
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -926,9 +1169,9 @@ void CLinuxRendererGL::LoadTextures(int source)
     }
     else
     {
-      glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[0]);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, rgbStride);
       glBindTexture(m_textureTarget, fields[FIELD_FULL][0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, im->height, GL_BGRA, GL_UNSIGNED_BYTE, m_rgbBuffer);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, im->height, GL_BGRA, GL_UNSIGNED_BYTE, rgb);
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
       VerifyGLState();
@@ -941,13 +1184,15 @@ void CLinuxRendererGL::LoadTextures(int source)
     if (deinterlacing)
     {
       // Load Y fields
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][0]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[0]*2);
       glBindTexture(m_textureTarget, fields[FIELD_ODD][0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[0]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[0]);
 
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, im->stride[0]);
       glBindTexture(m_textureTarget, fields[FIELD_EVEN][0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[0]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, (im->height>>1), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[0]);
 
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -955,9 +1200,11 @@ void CLinuxRendererGL::LoadTextures(int source)
     else
     {
       // Load Y plane
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][0]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[0]);
       glBindTexture(m_textureTarget, fields[FIELD_FULL][0]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, im->height, GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[0]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, im->width, im->height, GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[0]);
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     }
@@ -985,23 +1232,31 @@ void CLinuxRendererGL::LoadTextures(int source)
     {
       // Load Even U & V Fields
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[1]*2);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][1]);
       glBindTexture(m_textureTarget, fields[FIELD_ODD][1]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[1]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[1]);
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[2]*2);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][2]);
       glBindTexture(m_textureTarget, fields[FIELD_ODD][2]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[2]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[2]);
 
       // Load Odd U & V Fields
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, im->stride[1]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[1]*2);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][1]);
       glBindTexture(m_textureTarget, fields[FIELD_EVEN][1]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[1]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[1]);
 
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, im->stride[2]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, im->stride[2]*2);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][2]);
       glBindTexture(m_textureTarget, fields[FIELD_EVEN][2]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[2]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> (im->cshift_y+1)), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[2]);
       VerifyGLState();
 
       glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
@@ -1010,21 +1265,52 @@ void CLinuxRendererGL::LoadTextures(int source)
     else
     {
       glPixelStorei(GL_UNPACK_ROW_LENGTH,im->stride[1]);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][1]);
       glBindTexture(m_textureTarget, fields[FIELD_FULL][1]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> im->cshift_y), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[1]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> im->cshift_y), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[1]);
       VerifyGLState();
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH,im->stride[2]);
+      if (usePBO)
+        glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo[source][2]);
       glBindTexture(m_textureTarget, fields[FIELD_FULL][2]);
-      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> im->cshift_y), GL_LUMINANCE, GL_UNSIGNED_BYTE, im->plane[2]);
+      glTexSubImage2D(m_textureTarget, 0, 0, 0, (im->width >> im->cshift_x), (im->height >> im->cshift_y), GL_LUMINANCE, GL_UNSIGNED_BYTE, planes[2]);
       VerifyGLState();
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
     }
+
+    if (usePBO)
+    {
+      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+      SetFence(source);
+    }
+  }
+
+  if (!m_bRGBImageSet)
+  {
+    uploaded.valid         = true;
+    uploaded.deinterlacing = deinterlacing;
+    uploaded.brightness    = g_stSettings.m_currentVideoSettings.m_Brightness;
+    uploaded.contrast      = g_stSettings.m_currentVideoSettings.m_Contrast;
+
     SetEvent(m_eventTexturesDone[source]);
   }
 
   glDisable(m_textureTarget);
+
+  // hand the other images back to the player once the uploads from them have finished,
+  // those which are still going are looked at again next time round.
+  for (int i = 0; i < m_NumYV12Buffers; i++)
+  {
+    if (i != source && m_pbo[i][0] && !m_pboMapped[i] && FenceDone(i))
+      MapPBO(i, m_fenceType == FENCE_NONE);
+  }
+
+  LARGE_INTEGER end;
+  QueryPerformanceCounter(&end);
+  g_dvdPerformanceCounter.AddRenderUpload(end.QuadPart - start.QuadPart);
 }
 
 void CLinuxRendererGL::Reset()
@@ -1033,6 +1319,7 @@ void CLinuxRendererGL::Reset()
   {
     /* reset all image flags, this will cleanup textures later */
     m_image[i].flags = 0;
+    m_uploaded[i].valid = false;
     /* reset texture locks, a bit ugly, could result in tearing */
     SetEvent(m_eventTexturesDone[i]);
   }
@@ -1142,6 +1429,10 @@ unsigned int CLinuxRendererGL::DrawSlice(unsigned char *src[], int stride[], int
     return -1;
 
   YV12Image &im = m_image[index];
+  if (!im.plane[0])
+    return -1;
+
+  m_uploaded[index].valid = false;
   // copy Y
   p = 0;
   d = (BYTE*)im.plane[p] + im.stride[p] * y + x;
@@ -1400,6 +1691,7 @@ void CLinuxRendererGL::UnInit()
     delete [] m_rgbBuffer;
     m_rgbBuffer = NULL;
   }
+  m_rgbSource = NULL;
 }
 
 
@@ -2176,6 +2468,8 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
   YV12Image &im = m_image[index];
   YUVFIELDS &fields = m_YUVTexture[index];
 
+  ReleaseImageRef(index);
+
   if( fields[FIELD_FULL][0] == 0 ) return;
 
   CLog::Log(LOGDEBUG, "Deleted YV12 texture %i", index);
@@ -2196,6 +2490,15 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
       }
     }
   }
+
+  if (m_pbo[index][0])
+  {
+    UnmapPBO(index);
+    DeleteFence(index);
+    glDeleteBuffersARB(MAX_PLANES, m_pbo[index]);
+    memset(m_pbo[index], 0, sizeof(m_pbo[index]));
+    CLog::Log(LOGDEBUG, "GL: Deleting pixel buffers %d", index);
+  }
   g_graphicsContext.EndPaint();
 
   for(int p = 0;p<MAX_PLANES;p++)
@@ -2229,6 +2532,8 @@ bool CLinuxRendererGL::CreateYV12Texture(int index, bool clear)
   YV12Image &im = m_image[index];
   YUVFIELDS &fields = m_YUVTexture[index];
 
+  m_uploaded[index].valid = false;
+
   if (clear)
   {
     DeleteYV12Texture(index);
@@ -2239,9 +2544,24 @@ bool CLinuxRendererGL::CreateYV12Texture(int index, bool clear)
     im.stride[0] = im.width;
     im.stride[1] = im.width/2;
     im.stride[2] = im.width/2;
-    im.plane[0] = new BYTE[im.width * m_iSourceHeight];
-    im.plane[1] = new BYTE[(im.width/2) * (m_iSourceHeight/2)];
-    im.plane[2] = new BYTE[(im.width/2) * (m_iSourceHeight/2)];
+
+    if (UsePBO())
+    {
+      glGenBuffersARB(MAX_PLANES, m_pbo[index]);
+      if (!MapPBO(index, true))
+      {
+        CLog::Log(LOGWARNING, "GL: Unable to map pixel buffers, falling back to client memory");
+        glDeleteBuffersARB(MAX_PLANES, m_pbo[index]);
+        memset(m_pbo[index], 0, sizeof(m_pbo[index]));
+      }
+    }
+
+    if (!m_pbo[index][0])
+    {
+      im.plane[0] = new BYTE[im.width * m_iSourceHeight];
+      im.plane[1] = new BYTE[(im.width/2) * (m_iSourceHeight/2)];
+      im.plane[2] = new BYTE[(im.width/2) * (m_iSourceHeight/2)];
+    }
 
     im.cshift_x = 1;
     im.cshift_y = 1;
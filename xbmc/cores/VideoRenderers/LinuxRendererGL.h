@@ -11,13 +11,15 @@
 #include "VideoShaders/VideoFilterShader.h"
 #include "../../settings/VideoSettings.h"
 #include "RenderFlags.h"
+#include "../dvdplayer/DVDCodecs/Video/DVDVideoBuffer.h"
 
 namespace Surface { class CSurface; }
 
 using namespace Surface;
 using namespace Shaders;
 
-#define NUM_BUFFERS 3
+// the most images the ring can have, advancedsettings.xml <video><renderbuffers> picks how many
+#define NUM_BUFFERS 5
 
 #define MAX_PLANES 3
 #define MAX_FIELDS 3
@@ -147,6 +149,11 @@ public:
   virtual bool SupportsMultiPassRendering();
   
   virtual void SetRGB32Image(const char *image, int nHeight, int nWidth, int nPitch);
+  virtual void SetRGB32ImageRef(const char *image, int nHeight, int nWidth, int nPitch);
+
+  // between GetImage and ReleaseImage, makes the image upload straight from the buffer
+  // instead of being written to. the buffer is held until the image is written again.
+  virtual bool SetImageRef(int source, CDVDVideoBuffer *buffer, BYTE *plane[], int stride[]);
 
 protected:
   virtual void Render(DWORD flags, int renderBuffer);
@@ -157,6 +164,13 @@ protected:
   ESCALINGMETHOD GetDefaultUpscalingMethod();
   bool IsSoftwareUpscaling();
   void InitializeSoftwareUpscaling();
+  void ReleaseImageRef(int source);
+  bool UsePBO();
+  bool MapPBO(int index, bool orphan);
+  void UnmapPBO(int index);
+  void SetFence(int index);
+  bool FenceDone(int index);
+  void DeleteFence(int index);
   
   virtual void ManageDisplay();
   void CopyAlpha(int w, int h, unsigned char* src, unsigned char *srca, int srcstride, unsigned char* dst, unsigned char* dsta, int dststride);
@@ -227,6 +241,35 @@ protected:
 
   // Raw data used by renderer
   YV12Image m_image[NUM_BUFFERS];
+  CDVDVideoBuffer *m_imageRef[NUM_BUFFERS];             // decoder buffer an image is showing, if any
+  BYTE            *m_imagePlanes[NUM_BUFFERS][MAX_PLANES];  // our own planes meanwhile
+  unsigned         m_imageStrides[NUM_BUFFERS][MAX_PLANES];
+
+  // pixel buffer objects holding the images, if supported. while an image can be written
+  // they're mapped and its planes point into them, once it's uploaded they're unmapped and
+  // the planes are NULL until the render thread maps them again.
+  GLuint m_pbo[NUM_BUFFERS][MAX_PLANES];
+  bool   m_pboMapped[NUM_BUFFERS];
+
+  // set after the uploads from an image's pixel buffers, they're only mapped again once it has
+  // passed. without fence support their storage is orphaned instead.
+  enum FenceType
+  {
+    FENCE_NONE = 0,
+    FENCE_APPLE,
+    FENCE_NV
+  };
+  FenceType m_fenceType;
+  GLuint    m_fence[NUM_BUFFERS];
+
+  // what an image's textures were last loaded with, so they're only loaded again if it changed
+  struct SUploaded
+  {
+    bool valid;
+    bool deinterlacing;
+    int  brightness;
+    int  contrast;
+  } m_uploaded[NUM_BUFFERS];
   int m_currentField;
   int m_reloadShaders;
 
@@ -268,6 +311,7 @@ protected:
   DllSwScale  m_dllSwScale;
   BYTE	     *m_rgbBuffer;  // if software scale is used, this will hold the result image
   int	      m_rgbBufferSize;
+  const BYTE *m_rgbSource;  // if set, the RGB image is uploaded straight from here instead of m_rgbBuffer
 
   bool        m_bRGBImageSet;
   
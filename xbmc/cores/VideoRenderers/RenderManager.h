@@ -91,6 +91,25 @@ public:
     if (m_pRenderer)
       m_pRenderer->SetRGB32Image(image, nHeight, nWidth, nPitch);    
   }
+  
+  // renders from image without copying it, until another image (or NULL) is set
+  inline void SetRGB32ImageRef(const char *image, int nHeight, int nWidth, int nPitch)
+  {
+    CSharedLock lock(m_sharedSection);
+    if (m_pRenderer)
+      m_pRenderer->SetRGB32ImageRef(image, nHeight, nWidth, nPitch);
+  }
+
+#ifdef HAS_SDL_OPENGL
+  // between GetImage and ReleaseImage, renders the image from buffer instead of copying it
+  inline bool SetImageRef(int source, CDVDVideoBuffer *buffer, BYTE *plane[], int stride[])
+  {
+    CSharedLock lock(m_sharedSection);
+    if (m_pRenderer)
+      return m_pRenderer->SetImageRef(source, buffer, plane, stride);
+    return false;
+  }
+#endif
 
 #ifdef _LINUX
   // should be called from the GUI thread after playback has finished
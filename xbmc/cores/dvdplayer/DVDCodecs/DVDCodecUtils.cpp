@@ -31,6 +31,7 @@ DVDVideoPicture* CDVDCodecUtils::AllocatePicture(int iWidth, int iHeight)
   {
     pPicture->iWidth = iWidth;
     pPicture->iHeight = iHeight;
+    pPicture->pBuffer = NULL;
 
     int w = iWidth / 2;
     int h = iHeight / 2;
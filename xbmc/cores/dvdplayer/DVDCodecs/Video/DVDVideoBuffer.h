@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#undef ALIGN
+#define ALIGN(value, alignment) (((value)+((alignment)-1))&~((alignment)-1))
+
+// YV12 picture memory which the decoder decodes into and the renderer can upload from
+// directly. Both hold a reference while they use it, the memory goes away with the last one.
+class CDVDVideoBuffer
+{
+public:
+  // room around the picture for decoders which draw past its edges
+  enum { EDGE = 16 };
+
+  CDVDVideoBuffer(int width, int height)
+  {
+    m_references = 1;
+    m_width = width;
+    m_height = height;
+
+    int w = ALIGN(width, 16) + 4 * EDGE;
+    int h = ALIGN(height, 32) + 2 * EDGE + 2;
+
+    iLineSize[0] = ALIGN(w, 32);
+    iLineSize[1] = iLineSize[0] >> 1;
+    iLineSize[2] = iLineSize[0] >> 1;
+
+    int size[3] = { iLineSize[0] * h, iLineSize[1] * (h >> 1), iLineSize[2] * (h >> 1) };
+    int offset[3] = { iLineSize[0] * EDGE + EDGE, iLineSize[1] * (EDGE >> 1) + EDGE, iLineSize[2] * (EDGE >> 1) + EDGE };
+
+    for (int i = 0; i < 3; i++)
+    {
+      m_pMemory[i] = new BYTE[size[i] + 32];
+      data[i] = (BYTE*)ALIGN((uintptr_t)m_pMemory[i], 32) + offset[i];
+    }
+  }
+
+  /**
+   * increase the reference counter by one.
+   */
+  long Acquire()
+  {
+    long count = InterlockedIncrement(&m_references);
+    return count;
+  }
+
+  /**
+   * decrease the reference counter by one.
+   */
+  long Release()
+  {
+    long count = InterlockedDecrement(&m_references);
+    if (count == 0) delete this;
+    return count;
+  }
+
+  long GetNrOfReferences()
+  {
+    return m_references;
+  }
+
+  bool IsSize(int width, int height) const { return m_width == width && m_height == height; }
+
+  BYTE* data[3];
+  int iLineSize[3];
+
+private:
+  ~CDVDVideoBuffer()
+  {
+    for (int i = 0; i < 3; i++)
+      delete[] m_pMemory[i];
+  }
+
+  BYTE* m_pMemory[3];
+  int m_width;
+  int m_height;
+  long m_references;
+};
@@ -28,6 +28,8 @@
 #define FRAME_TYPE_B 3
 #define FRAME_TYPE_D 4
 
+class CDVDVideoBuffer;
+
 // video structure with PIX_FMT_YUV420P data
 // should be entirely filled by all codecs
 typedef struct stDVDVideoPicture
@@ -35,6 +37,7 @@ typedef struct stDVDVideoPicture
   double pts; // timestamp in seconds, used in the CDVDPlayer class to keep track of pts
   BYTE* data[4];      // [4] = alpha channel, currently not used
   int iLineSize[4];   // [4] = alpha channel, currently not used
+  CDVDVideoBuffer* pBuffer; // if set, data points into this and it may be held on to after the next Decode call
 
   unsigned int iFlags;
   
@@ -80,6 +83,12 @@ typedef std::vector<CDVDCodecOption> CDVDCodecOptions;
 #define VC_PICTURE  0x00000004  // the decoder got a picture, call Decode(NULL, 0) again to parse the rest of the data
 #define VC_USERDATA 0x00000008  // the decoder found some userdata,  call Decode(NULL, 0) again to parse the rest of the data
 
+// VC_DROP_ levels, how much quality a codec may give up to catch up, see SetDropLevel()
+#define VC_DROP_NONE           0  // decode everything
+#define VC_DROP_DEBLOCK_NONREF 1  // skip the loop filter on pictures nothing refers to
+#define VC_DROP_DEBLOCK        2  // skip the loop filter on all pictures
+#define VC_DROP_FRAMES         3  // drop pictures nothing refers to, same as SetDropState(true)
+
 class CDVDVideoCodec
 {
 public:
@@ -133,6 +142,12 @@ public:
    */
   virtual void SetDropState(bool bDrop) = 0;
 
+  /*
+   * will be called by video player with one of the VC_DROP_ levels, depending on how late it is
+   * codecs which can't reduce quality in steps just drop frames at the highest level
+   */
+  virtual void SetDropLevel(int iLevel) { SetDropState(iLevel >= VC_DROP_FRAMES); }
+
   /*
    *
    * should return codecs name
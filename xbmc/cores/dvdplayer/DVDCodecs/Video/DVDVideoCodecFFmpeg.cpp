@@ -38,6 +38,74 @@
 #define RINT lrint
 #endif
 
+// most buffers the decoder may be holding on to at once, h264 needs 16 references plus
+// the picture being decoded and whatever it's waiting to reorder.
+#define MAX_VIDEO_BUFFERS 32
+
+int my_get_buffer(struct AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  // we only render planar YV12 without a copy
+  if (avctx->pix_fmt != PIX_FMT_YUV420P && avctx->pix_fmt != PIX_FMT_YUVJ420P)
+    return ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+
+  CDVDVideoBuffer* buffer = NULL;
+  for (unsigned int i = 0; i < ctx->m_buffers.size() && !buffer; i++)
+  {
+    if (ctx->m_buffers[i]->GetNrOfReferences() > 1)
+      continue;
+
+    if (ctx->m_buffers[i]->IsSize(avctx->width, avctx->height))
+      buffer = ctx->m_buffers[i];
+    else
+    { // left over from before a size change
+      ctx->m_buffers[i]->Release();
+      ctx->m_buffers.erase(ctx->m_buffers.begin() + i--);
+    }
+  }
+
+  if (!buffer)
+  {
+    if (ctx->m_buffers.size() >= MAX_VIDEO_BUFFERS)
+      return ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+
+    buffer = new CDVDVideoBuffer(avctx->width, avctx->height);
+    ctx->m_buffers.push_back(buffer);
+  }
+
+  buffer->Acquire();
+
+  for (int i = 0; i < 3; i++)
+  {
+    pic->base[i] = pic->data[i] = buffer->data[i];
+    pic->linesize[i] = buffer->iLineSize[i];
+  }
+  pic->base[3] = pic->data[3] = NULL;
+  pic->linesize[3] = 0;
+
+  pic->type = FF_BUFFER_TYPE_USER;
+  pic->opaque = buffer;
+  pic->age = 256*256*256*64; // never assume what's in it from last time
+  pic->reordered_opaque = avctx->reordered_opaque;
+  return 0;
+}
+
+void my_release_buffer(struct AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  if (pic->type != FF_BUFFER_TYPE_USER)
+  {
+    ctx->m_dllAvCodec.avcodec_default_release_buffer(avctx, pic);
+    return;
+  }
+
+  ((CDVDVideoBuffer*)pic->opaque)->Release();
+  for (int i = 0; i < 4; i++)
+    pic->data[i] = NULL;
+  pic->opaque = NULL;
+}
 
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
@@ -50,6 +118,9 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 
   m_iScreenWidth = 0;
   m_iScreenHeight = 0;
+
+  m_iDropLevel = VC_DROP_NONE;
+  m_skipLoopFilter = AVDISCARD_DEFAULT;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -87,6 +158,13 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   if (pCodec->id != CODEC_ID_H264 && pCodec->capabilities & CODEC_CAP_DR1)
     m_pCodecContext->flags |= CODEC_FLAG_EMU_EDGE;
 
+  // decode into buffers the renderer can hold on to, saving a copy of each picture
+  if (pCodec->capabilities & CODEC_CAP_DR1)
+  {
+    m_pCodecContext->get_buffer = my_get_buffer;
+    m_pCodecContext->release_buffer = my_release_buffer;
+  }
+
   // Hack to correct wrong frame rates that seem to be generated by some
   // codecs
   if (m_pCodecContext->time_base.den > 1000 && m_pCodecContext->time_base.num == 1)
@@ -104,9 +182,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   }
 
   AVDiscard discardVals[] = {AVDISCARD_DEFAULT, AVDISCARD_BIDIR, AVDISCARD_ALL};
-  AVDiscard avDiscard = discardVals[g_guiSettings.GetInt("videoplayer.skiploopfilter")];
-  if (avDiscard != AVDISCARD_DEFAULT)
-    m_pCodecContext->skip_loop_filter = avDiscard;
+  m_skipLoopFilter = discardVals[g_guiSettings.GetInt("videoplayer.skiploopfilter")];
+  m_iDropLevel = VC_DROP_NONE;
+  if (m_skipLoopFilter != AVDISCARD_DEFAULT)
+    m_pCodecContext->skip_loop_filter = m_skipLoopFilter;
   
   // set any special options
   for(CDVDCodecOptions::iterator it = options.begin(); it != options.end(); it++)
@@ -157,38 +236,43 @@ void CDVDVideoCodecFFmpeg::Dispose()
     m_dllAvUtil.av_free(m_pCodecContext);
     m_pCodecContext = NULL;
   }
+
+  FreeBuffers();
   
   m_dllAvCodec.Unload();
   m_dllAvUtil.Unload();
 }
 
+void CDVDVideoCodecFFmpeg::FreeBuffers()
+{
+  // the renderer may still be holding on to some, they go away when it lets go
+  for (unsigned int i = 0; i < m_buffers.size(); i++)
+    m_buffers[i]->Release();
+  m_buffers.clear();
+}
+
 void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
 {
-  if( m_pCodecContext )
-  {
-    // i don't know exactly how high this should be set
-    // couldn't find any good docs on it. think it varies
-    // from codec to codec on what it does
+  SetDropLevel(bDrop ? VC_DROP_FRAMES : VC_DROP_NONE);
+}
 
-    //  2 seem to be to high.. it causes video to be ruined on following images
-    if( bDrop )
-    {
-      // TODO: 'hurry_up' has been deprecated in favor of the skip_* variables
-      // Use those instead.
+void CDVDVideoCodecFFmpeg::SetDropLevel(int iLevel)
+{
+  if (!m_pCodecContext || iLevel == m_iDropLevel)
+    return;
 
-      m_pCodecContext->hurry_up = 1;
-      //m_pCodecContext->skip_frame = AVDISCARD_NONREF;
-      //m_pCodecContext->skip_idct = AVDISCARD_NONREF;
-      //m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
-    }
-    else
-    {
-      m_pCodecContext->hurry_up = 0;
-      //m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
-      //m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      //m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
-    }
-  }
+  m_iDropLevel = iLevel;
+
+  // the loop filter is the cheapest thing to give up, the picture just gets a bit blocky.
+  // skipping non reference pictures is safe too, nothing later is decoded from them.
+  AVDiscard skipLoopFilter = AVDISCARD_DEFAULT;
+  if (iLevel >= VC_DROP_DEBLOCK)
+    skipLoopFilter = AVDISCARD_ALL;
+  else if (iLevel >= VC_DROP_DEBLOCK_NONREF)
+    skipLoopFilter = AVDISCARD_NONREF;
+
+  m_pCodecContext->skip_loop_filter = std::max(skipLoopFilter, m_skipLoopFilter);
+  m_pCodecContext->skip_frame = iLevel >= VC_DROP_FRAMES ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
 }
 
 union pts_union
@@ -235,7 +319,7 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double pts)
     return VC_ERROR;
   }
 
-  if (len != iSize && !m_pCodecContext->hurry_up)
+  if (len != iSize && m_pCodecContext->skip_frame == AVDISCARD_DEFAULT)
     CLog::Log(LOGWARNING, "%s - avcodec_decode_video didn't consume the full packet. size: %d, consumed: %d", __FUNCTION__, iSize, len);
 
   if (!iGotPicture)
@@ -345,6 +429,7 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
       pDvdVideoPicture->data[i]      = m_pConvertFrame->data[i];
     for (int i = 0; i < 4; i++)
       pDvdVideoPicture->iLineSize[i] = m_pConvertFrame->linesize[i];
+    pDvdVideoPicture->pBuffer = NULL;
   }
   else
   {
@@ -352,6 +437,7 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
       pDvdVideoPicture->data[i]      = frame->data[i];
     for (int i = 0; i < 4; i++)
       pDvdVideoPicture->iLineSize[i] = frame->linesize[i];
+    pDvdVideoPicture->pBuffer = frame->type == FF_BUFFER_TYPE_USER ? (CDVDVideoBuffer*)frame->opaque : NULL;
   }
   pDvdVideoPicture->iRepeatPicture = frame->repeat_pict;
   pDvdVideoPicture->iFlags = DVP_FLAG_ALLOCATED;    
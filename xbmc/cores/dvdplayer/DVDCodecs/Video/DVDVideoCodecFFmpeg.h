@@ -25,6 +25,7 @@
 #include "cores/ffmpeg/DllAvCodec.h"
 #include "cores/ffmpeg/DllAvFormat.h"
 #include "cores/ffmpeg/DllSwScale.h"
+#include "DVDVideoBuffer.h"
 
 class CDVDVideoCodecFFmpeg : public CDVDVideoCodec
 {
@@ -37,6 +38,7 @@ public:
   virtual void Reset();
   virtual bool GetPicture(DVDVideoPicture* pDvdVideoPicture);
   virtual void SetDropState(bool bDrop);
+  virtual void SetDropLevel(int iLevel);
   virtual const char* GetName() { return "FFmpeg"; };
 
 protected:
@@ -44,6 +46,7 @@ protected:
   friend void my_release_buffer(struct AVCodecContext *, AVFrame *);
 
   void GetVideoAspect(AVCodecContext* CodecContext, unsigned int& iWidth, unsigned int& iHeight);
+  void FreeBuffers();
 
   AVFrame* m_pFrame;
   AVCodecContext* m_pCodecContext;
@@ -56,6 +59,13 @@ protected:
   int m_iScreenWidth;
   int m_iScreenHeight;
 
+  // buffers handed to the decoder, we hold one reference to each. one which nobody else
+  // holds a reference to is free to be decoded into again.
+  std::vector<CDVDVideoBuffer*> m_buffers;
+
+  int m_iDropLevel;
+  AVDiscard m_skipLoopFilter; // what the user asked for, we never skip less than this
+
   DllAvCodec m_dllAvCodec;
   DllAvUtil  m_dllAvUtil;
   DllSwScale m_dllSwScale;
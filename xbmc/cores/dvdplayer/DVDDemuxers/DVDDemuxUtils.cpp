@@ -26,13 +26,88 @@ extern "C" {
 #include "cores/ffmpeg/avcodec.h"
 }
 
+// packets are recycled by the size of their payload, in four classes per power of two between
+// 1k and 2M, so at most a quarter of a payload is wasted. bigger ones come straight from the heap.
+#define POOL_MIN_BITS   10
+#define POOL_MAX_BITS   20
+#define POOL_CLASSES    (2 + (POOL_MAX_BITS - POOL_MIN_BITS + 1) * 4)
+#define POOL_NO_CLASS   -1
+
+// freed payloads kept beyond this are given back
+#define POOL_MAX_FREE   (16 * 1024 * 1024)
+
+typedef struct DemuxPacketPooled
+{
+  DemuxPacket packet;   // must come first, it's what everyone else sees
+  int iClass;
+  int iCapacity;        // of the payload, including the padding
+  struct DemuxPacketPooled* pNext;
+} DemuxPacketPooled;
+
+static CCriticalSection   g_poolSection;
+static DemuxPacketPooled* g_poolFree[POOL_CLASSES];
+static int                g_poolFreeBytes    = 0;
+static __int64            g_poolAllocated    = 0;
+static __int64            g_poolReused       = 0;
+static int                g_poolOutstanding  = 0;
+static int                g_poolPeak         = 0;
+
+// class 0 has no payload, class 1 holds up to 1k, then four per power of two
+static int GetPoolClass(int iSize, int& iCapacity)
+{
+  if (iSize <= 0)
+  {
+    iCapacity = 0;
+    return 0;
+  }
+  if (iSize <= (1 << POOL_MIN_BITS))
+  {
+    iCapacity = 1 << POOL_MIN_BITS;
+    return 1;
+  }
+
+  unsigned n = iSize - 1;
+  int bits = 0;
+  while ((n >> bits) > 1)
+    bits++;
+
+  if (bits > POOL_MAX_BITS)
+  {
+    iCapacity = iSize;
+    return POOL_NO_CLASS;
+  }
+
+  int sub = (n >> (bits - 2)) & 3;
+  iCapacity = (5 + sub) << (bits - 2);
+  return 2 + (bits - POOL_MIN_BITS) * 4 + sub;
+}
+
+static void DeletePooledPacket(DemuxPacketPooled* pPooled)
+{
+  if (pPooled->packet.pData) _aligned_free(pPooled->packet.pData);
+  delete pPooled;
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);    
-      delete pPacket;
+      DemuxPacketPooled* pPooled = (DemuxPacketPooled*)pPacket;
+
+      CSingleLock lock(g_poolSection);
+      g_poolOutstanding--;
+
+      if (pPooled->iClass != POOL_NO_CLASS && g_poolFreeBytes + pPooled->iCapacity <= POOL_MAX_FREE)
+      {
+        pPooled->pNext = g_poolFree[pPooled->iClass];
+        g_poolFree[pPooled->iClass] = pPooled;
+        g_poolFreeBytes += pPooled->iCapacity;
+        return;
+      }
+      lock.Leave();
+
+      DeletePooledPacket(pPooled);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -42,45 +117,105 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+    * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+    * this is mainly needed because some optimized bitstream readers read 
+    * 32 or 64 bit at once and could read over the end<br>
+    * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+    * MPEG bitstreams could cause overread and segfault
+    */ 
+  int iCapacity;
+  int iClass = GetPoolClass(iDataSize > 0 ? iDataSize + FF_INPUT_BUFFER_PADDING_SIZE : 0, iCapacity);
 
-  try
+  DemuxPacketPooled* pPooled = NULL;
   {
-    memset(pPacket, 0, sizeof(DemuxPacket));
+    CSingleLock lock(g_poolSection);
+    if (iClass != POOL_NO_CLASS && g_poolFree[iClass])
+    {
+      pPooled = g_poolFree[iClass];
+      g_poolFree[iClass] = pPooled->pNext;
+      g_poolFreeBytes -= pPooled->iCapacity;
+      g_poolReused++;
+    }
+    g_poolAllocated++;
+    g_poolOutstanding++;
+    if (g_poolOutstanding > g_poolPeak)
+      g_poolPeak = g_poolOutstanding;
+  }
 
-    if (iDataSize > 0)
+  try
+  {
+    if (!pPooled)
     {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read 
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */ 
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);    
-      if (!pPacket->pData)
+      BYTE* pData = iCapacity > 0 ? (BYTE*)_aligned_malloc(iCapacity, 16) : NULL;
+      if (iCapacity > 0 && !pData)
       {
-        FreeDemuxPacket(pPacket);
+        CSingleLock lock(g_poolSection);
+        g_poolOutstanding--;
         return NULL;
       }
 
-      // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+      pPooled = new DemuxPacketPooled;
+      memset(pPooled, 0, sizeof(DemuxPacketPooled));
+      pPooled->packet.pData = pData;
+      pPooled->iClass = iClass;
+      pPooled->iCapacity = iCapacity;
     }
 
+    DemuxPacket* pPacket = &pPooled->packet;
+    BYTE* pData = pPacket->pData;
+    memset(pPacket, 0, sizeof(DemuxPacket));
+    pPacket->pData = pData;
+
+    // reset the padding to 0
+    if (iDataSize > 0)
+      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+
     // setup defaults
     pPacket->dts       = DVD_NOPTS_VALUE;
     pPacket->pts       = DVD_NOPTS_VALUE;
     pPacket->iStreamId = -1;
+    return pPacket;
   }
   catch(...)
   {
     CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
-    FreeDemuxPacket(pPacket);
-    pPacket = NULL;
+    CSingleLock lock(g_poolSection);
+    g_poolOutstanding--;
   }  
-  return pPacket;
+  return NULL;
+}
+
+void CDVDDemuxUtils::TrimPool()
+{
+  DemuxPacketPooled* pFree[POOL_CLASSES];
+  {
+    CSingleLock lock(g_poolSection);
+    memcpy(pFree, g_poolFree, sizeof(pFree));
+    memset(g_poolFree, 0, sizeof(g_poolFree));
+    g_poolFreeBytes = 0;
+  }
+
+  for (int i = 0; i < POOL_CLASSES; i++)
+  {
+    while (pFree[i])
+    {
+      DemuxPacketPooled* pNext = pFree[i]->pNext;
+      DeletePooledPacket(pFree[i]);
+      pFree[i] = pNext;
+    }
+  }
+}
+
+CStdString CDVDDemuxUtils::GetPoolInfo()
+{
+  CSingleLock lock(g_poolSection);
+
+  CStdString strInfo;
+  strInfo.Format("packet pool: %lld allocated, %lld reused (%d%%), %d in use (peak %d), %d KB free",
+                 g_poolAllocated, g_poolReused, g_poolAllocated ? (int)(g_poolReused * 100 / g_poolAllocated) : 0,
+                 g_poolOutstanding, g_poolPeak, g_poolFreeBytes / 1024);
+  return strInfo;
 }
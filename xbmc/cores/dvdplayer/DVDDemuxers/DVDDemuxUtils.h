@@ -28,5 +28,9 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  // freed packets are kept for reuse, these give the memory back and tell how well it did
+  static void TrimPool();
+  static CStdString GetPoolInfo();
 };
 
@@ -23,6 +23,7 @@
 #include "FileItem.h"
 #include "Settings.h"
 #include "Picture.h"
+#include "utils/PixelConverter.h"
 
 
 #include "DVDFileInfo.h"
@@ -39,7 +40,6 @@
 
 #include "../ffmpeg/DllAvFormat.h"
 #include "../ffmpeg/DllAvCodec.h"
-#include "../ffmpeg/DllSwScale.h"
 
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
@@ -83,6 +83,9 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
     return false;
   }
 
+  // a thumb needs a few frames of each file, they shouldn't push what's playing out of the os cache
+  pInputStream->SetReadOnce(true);
+
   if (!pInputStream->Open(strPath.c_str(), ""))
   {
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", strPath.c_str());
@@ -176,28 +179,20 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
                 double aspect = (double)picture.iWidth / (double)picture.iHeight;
                 int nHeight = (int)((double)g_advancedSettings.m_thumbSize / aspect);
 
-                DllSwScale dllSwScale;
-                dllSwScale.Load();
-
-                BYTE *pOutBuf = (BYTE*)new int[nWidth * nHeight * 4];
-                struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight, 
-                      PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_RGB32, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-                uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2] };
-                int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2] };
-                uint8_t *dst[] = { pOutBuf, 0, 0 };
-                int     dstStride[] = { nWidth*4, 0, 0 };
+                BYTE *pRGBBuf = new BYTE[picture.iWidth * picture.iHeight * 4];
+                BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
+                BYTE *src[] = { picture.data[0], picture.data[1], picture.data[2] };
+                int   srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2] };
 
-                if (context)
-                {
-                  dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);  
-                  dllSwScale.sws_freeContext(context);
+                CPixelConverter::YV12ToRGB32(src, srcStride, picture.iWidth, picture.iHeight, pRGBBuf, picture.iWidth * 4);
+                CPixelConverter::ScaleRGB32(pRGBBuf, picture.iWidth, picture.iHeight, picture.iWidth * 4,
+                                            pOutBuf, nWidth, nHeight, nWidth * 4);
 
-                  CPicture out;
-                  out.CreateThumbnailFromSurface(pOutBuf, nWidth, nHeight, nWidth * 4, strTarget);
-                  bOk = true; 
-                }
+                CPicture out;
+                out.CreateThumbnailFromSurface(pOutBuf, nWidth, nHeight, nWidth * 4, strTarget);
+                bOk = true;
 
-                dllSwScale.Unload();                
+                delete [] pRGBBuf;
                 delete [] pOutBuf;
               }
               else 
@@ -241,6 +236,8 @@ void CDVDFileInfo::GetFileMetaData(const CStdString &strPath, CFileItem *pItem)
     return ;
   }
 
+  pInputStream->SetReadOnce(true);
+
   if (pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD) || !pInputStream->Open(strPath.c_str(), ""))
   {
     CLog::Log(LOGERROR, "%s - invalid stream in %s", __FUNCTION__, strPath.c_str());
@@ -54,6 +54,9 @@ public:
   virtual std::string& GetContent() { return m_content; };
   virtual std::string& GetFileName() { return m_strFileName; }
   virtual bool NextStream() { return false; }
+
+  // before Open, for files which are only looked at (thumbs, scans) and shouldn't stay in the os cache
+  virtual void SetReadOnce(bool readOnce) { }
   
   int GetBlockSize() { return DVDSTREAM_BLOCK_SIZE_FILE; }
   bool IsStreamType(DVDStreamType type) const { return m_streamType == type; }
@@ -30,6 +30,7 @@ CDVDInputStreamFile::CDVDInputStreamFile() : CDVDInputStream(DVDSTREAM_TYPE_FILE
 {
   m_pFile = NULL;
   m_eof = true;
+  m_readOnce = false;
 }
 
 CDVDInputStreamFile::~CDVDInputStreamFile()
@@ -54,6 +55,9 @@ bool CDVDInputStreamFile::Open(const char* strFile, const std::string& content)
   if( CFileItem(strFile, false).IsInternetStream() )
     flags |= READ_CACHED;
 
+  if( m_readOnce )
+    flags |= READ_ONCE;
+
   // open file in binary mode
   if (!m_pFile->Open(strFile, true, flags))
   {
@@ -36,7 +36,10 @@ public:
   virtual __int64 GetLength();
   virtual BitstreamStats GetBitstreamStats() const ;
 
+  virtual void SetReadOnce(bool readOnce) { m_readOnce = readOnce; }
+
 protected:
   XFILE::CFile* m_pFile;
   bool m_eof;
+  bool m_readOnce;
 };
@@ -22,20 +22,36 @@
 #include "stdafx.h"
 #include "DVDMessageQueue.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
+#include "AC3Encoder/pa_memorybarrier.h"
 
 using namespace std;
 
+// packets which don't fit go through the list, in order, so this only has to cover the usual case
+#define RING_SIZE 1024
+#define RING_MASK (RING_SIZE - 1)
+
 CDVDMessageQueue::CDVDMessageQueue(const string &owner)
 {
   m_owner = owner;
   m_pFirstMessage = NULL;
   m_pLastMessage  = NULL;
+  m_iListCount    = 0;
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bInitialized  = false;
   m_bCaching      = false;
   m_bEmptied      = true;
   m_iMaxDataSize  = 0;
+
+  m_pRing             = new DVDMessageRingItem[RING_SIZE];
+  m_ringProducer      = 0;
+  m_iRingWrite        = 0;
+  m_iRingRead         = 0;
+  m_iRingFlush        = 0;
+  m_iRingBytesIn      = 0;
+  m_iRingBytesOut     = 0;
+  m_iRingBytesFlushed = 0;
+  m_bWaiting          = false;
   
   InitializeCriticalSection(&m_critSection);
   m_hEvent = CreateEvent(NULL, true, false, NULL);
@@ -45,6 +61,8 @@ CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
   Flush();
+  ClearRing();
+  delete [] m_pRing;
   
   DeleteCriticalSection(&m_critSection);
   CloseHandle(m_hEvent);
@@ -54,12 +72,30 @@ void CDVDMessageQueue::Init()
 {
   m_pFirstMessage = NULL;
   m_pLastMessage  = NULL;
+  m_iListCount    = 0;
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bEmptied      = true;
+  m_bWaiting      = false;
+  ClearRing();
+  m_ringProducer  = GetCurrentThreadId();
   m_bInitialized  = true;
 }
 
+void CDVDMessageQueue::ClearRing()
+{
+  // only called while nobody reads from the queue
+  for (unsigned i = m_iRingRead; i != m_iRingWrite; i++)
+    m_pRing[i & RING_MASK].pMsg->Release();
+
+  m_iRingWrite        = 0;
+  m_iRingRead         = 0;
+  m_iRingFlush        = 0;
+  m_iRingBytesIn      = 0;
+  m_iRingBytesOut     = 0;
+  m_iRingBytesFlushed = 0;
+}
+
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   EnterCriticalSection(&m_critSection);
@@ -78,6 +114,7 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
         pLast->pNext = pCurr->pNext;
         pCurr->pMsg->Release();
         delete pCurr;
+        m_iListCount--;
       }
       else
         pLast = pCurr;
@@ -92,6 +129,9 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
+    // the reader drops the packets in the ring, it may be holding on to the next one right now
+    m_iRingBytesFlushed = m_iRingBytesIn;
+    m_iRingFlush = m_iRingWrite;
     m_iDataSize = 0;
     m_bEmptied = true;
   }
@@ -119,8 +159,10 @@ void CDVDMessageQueue::End()
   m_bInitialized  = false;
   m_pFirstMessage = NULL;
   m_pLastMessage  = NULL;
+  m_iListCount    = 0;
   m_iDataSize     = 0;
   m_bAbortRequest = false;
+  ClearRing();
   
   LeaveCriticalSection(&m_critSection);
 }
@@ -140,6 +182,27 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
+  if (priority == 0 && pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && GetCurrentThreadId() == m_ringProducer &&
+      m_iRingWrite - m_iRingRead < RING_SIZE)
+  {
+    unsigned bytes = m_iRingBytesIn + ((CDVDMsgDemuxerPacket*)pMsg)->GetPacketSize();
+
+    DVDMessageRingItem& ringItem = m_pRing[m_iRingWrite & RING_MASK];
+    ringItem.pMsg  = pMsg;
+    ringItem.bytes = bytes;
+    m_iRingBytesIn = bytes;
+
+    PaUtil_WriteMemoryBarrier();
+    m_iRingWrite++;
+
+    // either the reader sees the packet before it waits, or we see that it waits
+    PaUtil_FullMemoryBarrier();
+    if (m_bWaiting)
+      SetEvent(m_hEvent);
+
+    return MSGQ_OK;
+  }
+
   DVDMessageListItem* msgItem = new DVDMessageListItem;
 
   if (!msgItem)
@@ -154,6 +217,8 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 
   EnterCriticalSection(&m_critSection);
 
+  msgItem->ringPos = m_iRingWrite;
+
   if(!m_pLastMessage || m_pLastMessage && m_pLastMessage->priority >= priority)
   {
     /* quick path to just add at the end */
@@ -181,6 +246,7 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     if (msgItem->pNext == m_pFirstMessage)
       m_pFirstMessage = msgItem;
   }
+  m_iListCount++;
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
   {
@@ -195,77 +261,138 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
   return MSGQ_OK;
 }
 
-MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int priority)
+bool CDVDMessageQueue::GetMessage(CDVDMsg** pMsg, int priority)
 {
-  *pMsg = NULL;
-  
-  DVDMessageListItem* msgItem;
-  int ret = 0;
+  if (m_bCaching)
+    return false;
 
-  if (!m_bInitialized)
+  unsigned write = m_iRingWrite;
+  PaUtil_ReadMemoryBarrier();
+
+  // drop whatever was flushed since we last looked
+  while (m_iRingRead != write && (int)(m_iRingFlush - m_iRingRead) > 0)
   {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
-    return MSGQ_NOT_INITIALIZED;
+    DVDMessageRingItem& ringItem = m_pRing[m_iRingRead & RING_MASK];
+    ringItem.pMsg->Release();
+    m_iRingBytesOut = ringItem.bytes;
+
+    PaUtil_FullMemoryBarrier();
+    m_iRingRead++;
   }
 
-  EnterCriticalSection(&m_critSection);
+  bool bRingReady = m_iRingRead != write && priority <= 0;
 
-  while (!m_bAbortRequest)
+  if (m_iListCount > 0)
   {
-    msgItem = m_pFirstMessage;
-    if (msgItem && msgItem->priority >= priority && !m_bCaching)
+    EnterCriticalSection(&m_critSection);
+
+    // list messages are due once the ring packets put before them have been read
+    DVDMessageListItem* msgItem = m_pFirstMessage;
+    if (msgItem && msgItem->priority >= priority &&
+        (msgItem->priority > 0 || (int)(msgItem->ringPos - m_iRingRead) <= 0))
     {
       m_pFirstMessage = msgItem->pNext;
       
       if (!m_pFirstMessage) m_pLastMessage = NULL;
+      m_iListCount--;
 
       if (msgItem->pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
       {
         CDVDMsgDemuxerPacket* pMsgDemuxerPacket = (CDVDMsgDemuxerPacket*)msgItem->pMsg;
         m_iDataSize -= pMsgDemuxerPacket->GetPacketSize();
-        if(m_iDataSize == 0)
-        {
-          if(!m_bEmptied)
-            CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - retrieved last data packet of queue", m_owner.c_str());
-          m_bEmptied = true;
-        }
-        else
-          m_bEmptied = false;
       }
 
       *pMsg = msgItem->pMsg;
       
       delete msgItem; // free the list item we allocated in ::Put()
-      
-      ret = MSGQ_OK;
-      break;
+      LeaveCriticalSection(&m_critSection);
     }
-    else if (!iTimeoutInMilliSeconds)
+    else
+      LeaveCriticalSection(&m_critSection);
+  }
+
+  if (!*pMsg && bRingReady)
+  {
+    DVDMessageRingItem& ringItem = m_pRing[m_iRingRead & RING_MASK];
+    *pMsg = ringItem.pMsg;
+    m_iRingBytesOut = ringItem.bytes;
+
+    PaUtil_FullMemoryBarrier();
+    m_iRingRead++;
+  }
+
+  if (!*pMsg)
+    return false;
+
+  if ((*pMsg)->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    if(GetDataSize() == 0)
     {
-      ret = MSGQ_TIMEOUT;
-      break;
+      if(!m_bEmptied)
+        CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - retrieved last data packet of queue", m_owner.c_str());
+      m_bEmptied = true;
     }
     else
+      m_bEmptied = false;
+  }
+
+  return true;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int priority)
+{
+  *pMsg = NULL;
+
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  while (!m_bAbortRequest)
+  {
+    if (GetMessage(pMsg, priority))
+      return MSGQ_OK;
+
+    if (!iTimeoutInMilliSeconds)
+      return MSGQ_TIMEOUT;
+
+    // packets are only signalled when we say we're waiting, so look once more after saying so
+    ResetEvent(m_hEvent);
+    m_bWaiting = true;
+    PaUtil_FullMemoryBarrier();
+
+    if (GetMessage(pMsg, priority))
     {
-      ResetEvent(m_hEvent);
-      LeaveCriticalSection(&m_critSection);
-      
-      // wait for a new message
-      if (WaitForSingleObject(m_hEvent, iTimeoutInMilliSeconds) == WAIT_TIMEOUT)
-      {
-        // just return here directly, we have already left critical section
-        return MSGQ_TIMEOUT;
-      }
-      EnterCriticalSection(&m_critSection);
+      m_bWaiting = false;
+      return MSGQ_OK;
     }
+    if (m_bAbortRequest)
+      break;
+
+    // wait for a new message
+    DWORD result = WaitForSingleObject(m_hEvent, iTimeoutInMilliSeconds);
+    m_bWaiting = false;
+    if (result == WAIT_TIMEOUT)
+      return MSGQ_TIMEOUT;
   }
-  LeaveCriticalSection(&m_critSection);
+  m_bWaiting = false;
   
-  if (m_bAbortRequest) return MSGQ_ABORT;
-  
-  return (MsgQueueReturnCode)ret;
+  return MSGQ_ABORT;
 }
 
+int CDVDMessageQueue::GetDataSize() const
+{
+  // the ring's counters only ever grow, whoever reads them
+  unsigned out     = m_iRingBytesOut;
+  unsigned flushed = m_iRingBytesFlushed;
+  unsigned in      = m_iRingBytesIn;
+  if ((int)(flushed - out) > 0)
+    out = flushed;
+
+  int ring = (int)(in - out);
+  return m_iDataSize + (ring > 0 ? ring : 0);
+}
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 {    
@@ -282,6 +409,16 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
       count++;
     msgItem = msgItem->pNext;
   }
+
+  if (type == CDVDMsg::DEMUXER_PACKET)
+  {
+    unsigned read  = m_iRingRead;
+    unsigned flush = m_iRingFlush;
+    if ((int)(flush - read) > 0)
+      read = flush;
+    if ((int)(m_iRingWrite - read) > 0)
+      count += m_iRingWrite - read;
+  }
   
   LeaveCriticalSection(&m_critSection);
   return count;
@@ -29,9 +29,17 @@ typedef struct stDVDMessageListItem
   CDVDMsg* pMsg;
   struct stDVDMessageListItem *pNext;
   int priority;
+  unsigned ringPos; // packets written to the ring before this was put
 }
 DVDMessageListItem;
 
+typedef struct stDVDMessageRingItem
+{
+  CDVDMsg* pMsg;
+  unsigned bytes;   // size of all packets written to the ring up to and including this one
+}
+DVDMessageRingItem;
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK               = 1,
@@ -64,29 +72,46 @@ public:
   MsgQueueReturnCode Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int priority = 0);
 
   
-  int GetDataSize() const               { return m_iDataSize; }
+  int GetDataSize() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
   bool RecievedAbortRequest()           { return m_bAbortRequest; }
   void WaitUntilEmpty();
   
   // non messagequeue related functions
-  bool IsFull() const                   { return (m_iDataSize >= m_iMaxDataSize); }
+  bool IsFull() const                   { return (GetDataSize() >= m_iMaxDataSize); }
   void SetMaxDataSize(int iMaxDataSize) { m_iMaxDataSize = iMaxDataSize; }
   int GetMaxDataSize() const            { return m_iMaxDataSize; }
   bool IsInited() const                 { return m_bInitialized; }
 private:
 
+  bool GetMessage(CDVDMsg** pMsg, int priority);
+  void ClearRing();
+
   HANDLE m_hEvent;
   mutable CRITICAL_SECTION m_critSection;
   
   DVDMessageListItem* m_pFirstMessage;
   DVDMessageListItem* m_pLastMessage;
-  
-  bool m_bAbortRequest;
+  volatile int m_iListCount;
+
+  // demux packets from the thread which called Init() go through this single producer,
+  // single consumer ring, without locking or allocating. everything else goes through the
+  // list, which is ordered against the ring by the packets written to it so far.
+  DVDMessageRingItem* m_pRing;
+  DWORD m_ringProducer;
+  volatile unsigned m_iRingWrite;        // written by the producer
+  volatile unsigned m_iRingRead;         // written by the consumer
+  volatile unsigned m_iRingFlush;        // packets before this one are dropped when read
+  volatile unsigned m_iRingBytesIn;
+  volatile unsigned m_iRingBytesOut;
+  volatile unsigned m_iRingBytesFlushed;
+  volatile bool m_bWaiting;              // consumer is, or is about to be, waiting for the event
+
+  volatile bool m_bAbortRequest;
   bool m_bInitialized;
   bool m_bCaching;
 
-  int m_iDataSize;
+  volatile int m_iDataSize;              // of the packets in the list
   int m_iMaxDataSize;
   bool m_bEmptied;
   std::string m_owner;
@@ -118,6 +118,24 @@ HRESULT __stdcall DVDPerformanceCounterMainPerformance(PLARGE_INTEGER numerator,
   return S_OK;
 }
 
+// average time per picture the renderer spent uploading since the last time, in microseconds
+HRESULT __stdcall DVDPerformanceCounterRenderUpload(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = 0LL;
+  g_dvdPerformanceCounter.Lock();
+  if (g_dvdPerformanceCounter.m_renderUploads > 0)
+  {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    if (frequency.QuadPart > 0)
+      numerator->QuadPart = (g_dvdPerformanceCounter.m_renderUploadTicks * 1000000LL / frequency.QuadPart) / g_dvdPerformanceCounter.m_renderUploads;
+  }
+  g_dvdPerformanceCounter.m_renderUploadTicks = 0LL;
+  g_dvdPerformanceCounter.m_renderUploads = 0;
+  g_dvdPerformanceCounter.Unlock();
+  return S_OK;
+}
+
 CDVDPerformanceCounter g_dvdPerformanceCounter;
 
 CDVDPerformanceCounter::CDVDPerformanceCounter()
@@ -128,6 +146,8 @@ CDVDPerformanceCounter::CDVDPerformanceCounter()
   memset(&m_videoDecodePerformance, 0, sizeof(m_videoDecodePerformance)); // video decoding
   memset(&m_audioDecodePerformance, 0, sizeof(m_audioDecodePerformance)); // audio decoding + output to audio device
   memset(&m_mainPerformance,        0, sizeof(m_mainPerformance));        // reading files, demuxing, decoding of subtitles + menu overlays
+  m_renderUploadTicks = 0LL;                                              // loading pictures into the renderer's textures
+  m_renderUploads = 0;
   
   InitializeCriticalSection(&m_critSection);
   
@@ -151,6 +171,7 @@ bool CDVDPerformanceCounter::Initialize()
   DmRegisterPerformanceCounter("DVDVideoDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterVideoDecodePerformance);
   DmRegisterPerformanceCounter("DVDAudioDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterAudioDecodePerformance);
   DmRegisterPerformanceCounter("DVDMainPerformance",          DMCOUNT_SYNC, DVDPerformanceCounterMainPerformance);
+  DmRegisterPerformanceCounter("DVDRenderUploadTime",         DMCOUNT_SYNC, DVDPerformanceCounterRenderUpload);
 
 #endif
 
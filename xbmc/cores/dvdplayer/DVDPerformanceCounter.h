@@ -60,12 +60,18 @@ public:
   void EnableMainPerformance(HANDLE hThread)        { Lock(); m_mainPerformance.hThread = hThread; Unlock(); }
   void DisableMainPerformance()                     { Lock(); m_mainPerformance.hThread = NULL; Unlock(); }
 
+  // time the renderer spent loading a picture into its textures, in performance counter ticks
+  void AddRenderUpload(__int64 ticks)               { Lock(); m_renderUploadTicks += ticks; m_renderUploads++; Unlock(); }
+
   CDVDMessageQueue*         m_pAudioQueue;
   CDVDMessageQueue*         m_pVideoQueue;
   
   ProcessPerformance        m_videoDecodePerformance;
   ProcessPerformance        m_audioDecodePerformance;
   ProcessPerformance        m_mainPerformance;
+
+  __int64                   m_renderUploadTicks;
+  int                       m_renderUploads;
   
 private:
   CRITICAL_SECTION m_critSection;
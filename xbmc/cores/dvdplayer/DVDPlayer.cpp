@@ -1766,6 +1766,9 @@ void CDVDPlayer::OnExit()
 
     m_messenger.End();
 
+    // don't hold on to packets while nothing plays
+    CLog::Log(LOGNOTICE, "CDVDPlayer::OnExit() %s", CDVDDemuxUtils::GetPoolInfo().c_str());
+    CDVDDemuxUtils::TrimPool();
   }
   catch (...)
   {
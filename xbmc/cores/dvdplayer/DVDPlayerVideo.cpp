@@ -212,7 +212,7 @@ void CDVDPlayerVideo::Process()
   double frametime = (double)DVD_TIME_BASE / m_fFrameRate;
 
   int iDropped = 0; //frames dropped in a row
-  bool bRequestDrop = false;  
+  int iLateLevel = VC_DROP_NONE; //how much decoding quality we're giving up to catch up
 
   m_videoStats.Start();
 
@@ -350,17 +350,21 @@ void CDVDPlayerVideo::Process()
         m_iNrOfPicturesNotToSkip++;
       }
 
+      int iDropLevel = iLateLevel;
 #ifdef PROFILE
-      bRequestDrop = false;
+      iDropLevel = VC_DROP_NONE;
 #else
-      if (m_iNrOfPicturesNotToSkip > 0) bRequestDrop = false;
-      if (m_speed < 0)                  bRequestDrop = false;
-      if (m_bDropFrames == false)       bRequestDrop = false;
+      // when pictures mustn't be dropped, we can still skip the loop filter
+      if (m_iNrOfPicturesNotToSkip > 0) iDropLevel = min(iDropLevel, VC_DROP_DEBLOCK);
+      if (m_speed < 0)                  iDropLevel = min(iDropLevel, VC_DROP_DEBLOCK);
+      if (m_bDropFrames == false)       iDropLevel = min(iDropLevel, VC_DROP_DEBLOCK);
 #endif
 
       // if player want's us to drop this packet, do so nomatter what
       if(bPacketDrop)
-        bRequestDrop = true;
+        iDropLevel = VC_DROP_FRAMES;
+
+      bool bRequestDrop = iDropLevel >= VC_DROP_FRAMES;
 
 
       EnterCriticalSection(&m_critCodecSection);
@@ -368,7 +372,7 @@ void CDVDPlayerVideo::Process()
       // problem here, if one packet contains more than one frame
       // both frames will be dropped in that case instead of just the first
       // decoder still needs to provide an empty image structure, with correct flags
-      m_pVideoCodec->SetDropState(bRequestDrop);
+      m_pVideoCodec->SetDropLevel(iDropLevel);
 
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->pts);
       m_videoStats.AddSampleBytes(pPacket->iSize);
@@ -422,6 +426,7 @@ void CDVDPlayerVideo::Process()
             {
               mDeinterlace.Process(&picture);
               mDeinterlace.GetPicture(&picture);
+              picture.pBuffer = NULL;
             }
             else if( mInt == VS_INTERLACEMETHOD_RENDER_WEAVE || mInt == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED )
             { 
@@ -472,7 +477,13 @@ void CDVDPlayerVideo::Process()
             else
               iDropped = 0;
 
-            bRequestDrop = (iResult & EOS_VERYLATE) == EOS_VERYLATE;
+            // give up quality a step at a time while we're behind, and get it back the same way
+            if( (iResult & EOS_VERYLATE) == EOS_VERYLATE )
+              iLateLevel = VC_DROP_FRAMES;
+            else if( iResult & EOS_LATE )
+              iLateLevel = min(iLateLevel + 1, VC_DROP_DEBLOCK);
+            else if( iLateLevel > VC_DROP_NONE )
+              iLateLevel--;
           }
           else
           {
@@ -605,11 +616,20 @@ void CDVDPlayerVideo::Flush()
   m_messageQueue.Put(new CDVDMsg(CDVDMsg::GENERAL_FLUSH));
 }
 
-void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, YV12Image* pDest, double pts)
+void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, YV12Image* pDest, int index, double pts)
 {
   // remove any overlays that are out of time
   m_pOverlayContainer->CleanUp(min(pts, pts - m_iSubtitleDelay));
 
+#ifdef HAS_SDL_OPENGL
+  // with nothing to draw on top, the renderer can upload straight from the decoder's buffer
+  if (pSource->pBuffer && m_pOverlayContainer->GetSize() == 0)
+  {
+    if (g_renderManager.SetImageRef(index, pSource->pBuffer, pSource->data, pSource->iLineSize))
+      return;
+  }
+#endif
+
   // rendering spu overlay types directly on video memory costs a lot of processing power.
   // thus we allocate a temp picture, copy the original to it (needed because the same picture can be used more than once).
   // then do all the rendering on that temp picture and finaly copy it to video memory.
@@ -787,6 +807,8 @@ int CDVDPlayerVideo::OutputPicture(DVDVideoPicture* pPicture, double pts)
   // ask decoder to drop frames next round, as we are very late
   if( iClockSleep < -DVD_MSEC_TO_TIME(100) )
     result |= EOS_VERYLATE;
+  else if( iClockSleep < -iFrameDuration )
+    result |= EOS_LATE;
 
   if( m_speed < 0 )
   {
@@ -851,7 +873,7 @@ int CDVDPlayerVideo::OutputPicture(DVDVideoPicture* pPicture, double pts)
   if (index < 0) 
     return EOS_DROPPED;
 
-  ProcessOverlays(pPicture, &image, pts);
+  ProcessOverlays(pPicture, &image, index, pts);
   
   // tell the renderer that we've finished with the image (so it can do any
   // post processing before FlipPage() is called.)
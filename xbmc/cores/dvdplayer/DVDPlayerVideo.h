@@ -116,9 +116,10 @@ protected:
 #define EOS_ABORT 1
 #define EOS_DROPPED 2
 #define EOS_VERYLATE 4
+#define EOS_LATE 8
 
   int OutputPicture(DVDVideoPicture* pPicture, double pts);
-  void ProcessOverlays(DVDVideoPicture* pSource, YV12Image* pDest, double pts);
+  void ProcessOverlays(DVDVideoPicture* pSource, YV12Image* pDest, int index, double pts);
   void ProcessVideoUserData(DVDVideoUserData* pVideoUserData, double pts);
   
   double m_iCurrentPts; // last pts displayed
@@ -66,7 +66,7 @@ bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned i
 
   CSingleLock lock(m_critSection);
   // create our pcm buffer
-  m_pcmBuffer.Create((int)std::max<unsigned int>(2, nBufferSize) *
+  m_pcmBuffer.Create(std::max<unsigned int>(2, nBufferSize) *
                      INTERNAL_BUFFER_LENGTH);
 
   // reset our playback timing variables
@@ -161,11 +161,13 @@ void *CAudioDecoder::GetData(unsigned int size)
   if (m_gaplessBufferSize)
     memcpy(m_outputBuffer, m_gaplessBuffer, m_gaplessBufferSize*sizeof(float));
 
-  if (m_pcmBuffer.ReadBinary( (char *)(m_outputBuffer + m_gaplessBufferSize), (size - m_gaplessBufferSize) * sizeof(float)))
+  unsigned int bytes = (size - m_gaplessBufferSize) * sizeof(float);
+  if (m_pcmBuffer.GetMaxReadSize() >= bytes)
   {
+    m_pcmBuffer.Read((char *)(m_outputBuffer + m_gaplessBufferSize), bytes);
     m_gaplessBufferSize = 0;
     // check for end of file + end of buffer
-    if ( m_status == STATUS_ENDING && m_pcmBuffer.GetMaxReadSize() < (int) (OUTPUT_SAMPLES * sizeof(float)))
+    if ( m_status == STATUS_ENDING && m_pcmBuffer.GetMaxReadSize() < OUTPUT_SAMPLES * sizeof(float))
     {
       CLog::Log(LOGINFO, "CAudioDecoder::GetData() ending track - only have %u samples left", m_pcmBuffer.GetMaxReadSize() / sizeof(float));
       m_status = STATUS_ENDED;
@@ -203,27 +205,37 @@ int CAudioDecoder::ReadSamples(int numsamples)
 
   // Read in more data
   int maxsize = std::min<int>(INPUT_SAMPLES,
-                  (m_pcmBuffer.GetMaxWriteSize() / (int)(sizeof (float))));
+                  (m_pcmBuffer.GetMaxWriteSize() / sizeof (float)));
   numsamples = std::min<int>(numsamples, maxsize);
 
 	numsamples -= (numsamples % m_codec->m_Channels);  // make sure it's divisible by our number of channels
   if ( numsamples )
   {
+    // decode straight into the pcm buffer, unless it wraps before there's room for all of it
+    unsigned int space;
+    float *samples = (float *)m_pcmBuffer.ReserveWrite(space);
+    bool direct = space >= numsamples * sizeof(float);
+    if (!direct)
+      samples = m_inputBuffer;
+
     int actualsamples = 0;
     // if our codec sends floating point, then read it
     int result = READ_ERROR;
     if (m_codec->HasFloatData())
-      result = m_codec->ReadSamples(m_inputBuffer, numsamples, &actualsamples);
+      result = m_codec->ReadSamples(samples, numsamples, &actualsamples);
     else
-      result = ReadPCMSamples(m_inputBuffer, numsamples, &actualsamples);
+      result = ReadPCMSamples(samples, numsamples, &actualsamples);
 
     if ( result != READ_ERROR && actualsamples ) 
     {
       // do any post processing of the audio (eg replaygain etc.)
-      ProcessAudio(m_inputBuffer, actualsamples);
+      ProcessAudio(samples, actualsamples);
 
       // move it into our buffer
-      m_pcmBuffer.WriteBinary((char *)m_inputBuffer, actualsamples * sizeof(float));
+      if (direct)
+        m_pcmBuffer.CommitWrite(actualsamples * sizeof(float));
+      else
+        m_pcmBuffer.Write((char *)m_inputBuffer, actualsamples * sizeof(float));
 
       // update status
       if (m_status == STATUS_QUEUING && m_pcmBuffer.GetMaxReadSize() > m_pcmBuffer.Size() * 0.9)
@@ -331,17 +343,17 @@ int CAudioDecoder::ReadPCMSamples(float *buffer, int numsamples, int *actualsamp
   {
   case 8:
     for (i = 0; i < *actualsamples; i++)
-      m_inputBuffer[i] = 1.0f / 0x7f * (m_pcmInputBuffer[i] - 128);
+      buffer[i] = 1.0f / 0x7f * (m_pcmInputBuffer[i] - 128);
     break;
   case 16:
     *actualsamples /= 2;
     for (i = 0; i < *actualsamples; i++)
-      m_inputBuffer[i] = 1.0f / 0x7fff * ((short *)m_pcmInputBuffer)[i];
+      buffer[i] = 1.0f / 0x7fff * ((short *)m_pcmInputBuffer)[i];
     break;
   case 24:
     *actualsamples /= 3;
     for (i = 0; i < *actualsamples; i++)
-      m_inputBuffer[i] = 1.0f / 0x7fffff * (((int)m_pcmInputBuffer[3*i] << 0) | ((int)m_pcmInputBuffer[3*i+1] << 8) | (((int)((char *)m_pcmInputBuffer)[3*i+2]) << 16));
+      buffer[i] = 1.0f / 0x7fffff * (((int)m_pcmInputBuffer[3*i] << 0) | ((int)m_pcmInputBuffer[3*i+1] << 8) | (((int)((char *)m_pcmInputBuffer)[3*i+2]) << 16));
     break;
   }
   return result;
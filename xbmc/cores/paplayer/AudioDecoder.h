@@ -23,7 +23,7 @@
 
 #include "utils/Thread.h"
 #include "ICodec.h"
-#include "FileSystem/RingBuffer.h"
+#include "FileSystem/LockFreeRingBuffer.h"
 
 class CFileItem;
 
@@ -83,8 +83,8 @@ private:
 
   // block size (number of bytes per sample * number of channels)
   int m_blockSize;
-  // pcm buffer
-  CRingBuffer m_pcmBuffer;
+  // pcm buffer, codecs decode straight into it when there's room in one piece
+  CLockFreeRingBuffer m_pcmBuffer;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
@@ -93,7 +93,7 @@ private:
   float m_gaplessBuffer[OUTPUT_SAMPLES];
   unsigned int m_gaplessBufferSize;
 
-  // input buffer (for transferring data from the Codecs to our Pcm Ringbuffer
+  // input buffer (for transferring data from the Codecs to our Pcm Ringbuffer when it wraps
   BYTE m_pcmInputBuffer[INPUT_SIZE];
   float m_inputBuffer[INPUT_SAMPLES];
 
@@ -24,7 +24,9 @@
 #include "cores/IPlayer.h"
 #include "utils/Thread.h"
 #include "AudioDecoder.h"
-#ifndef __APPLE__
+#if defined(HAS_ALSA) && !defined(__APPLE__)
+#include "cores/Resampler.h"
+#elif !defined(__APPLE__)
 #include "cores/ssrc.h"
 #endif
 #include "../../utils/PCMAmplifier.h"
@@ -228,6 +230,7 @@ private:
   int               m_channelCount[2];
   int               m_sampleRate[2];
   int               m_bitsPerSample[2];
+  CResampler        m_resampler[2];
 #elif defined(_LINUX)
   IDirectSoundRenderer* m_pAudioDecoder[2];
   float             m_latency[2];
@@ -401,7 +401,8 @@ bool PAPlayer::CreateStream(int num, int channels, int samplerate, int bitspersa
     CHECK_ALSA(LOGERROR,"snd_pcm_prepare",nErr);
 
     // create our resampler  // upsample to XBMC_SAMPLE_RATE, only do this for sources with 1 or 2 channels
-    m_resampler[num].InitConverter(samplerate, bitspersample, channels, m_SampleRateOutput, m_BitsPerSampleOutput, PACKET_SIZE);
+    m_resampler[num].InitConverter(samplerate, bitspersample, channels, m_SampleRateOutput, m_BitsPerSampleOutput, PACKET_SIZE,
+                                   (CResampler::Quality)g_advancedSettings.m_audioResampleQuality);
 
     // set initial volume
     SetStreamVolume(num, g_stSettings.m_nVolumeLevel);
@@ -631,7 +632,8 @@ bool PAPlayer::ProcessPAP()
             {
               CLog::Log(LOGINFO, "PAPlayer: Restarting resampler due to a change in data format");
               m_resampler[m_currentStream].DeInitialize();
-              if (!m_resampler[m_currentStream].InitConverter(samplerate2, bitspersample2, channels2, XBMC_SAMPLE_RATE, 16, PACKET_SIZE))
+              if (!m_resampler[m_currentStream].InitConverter(samplerate2, bitspersample2, channels2, XBMC_SAMPLE_RATE, 16, PACKET_SIZE,
+                                                              (CResampler::Quality)g_advancedSettings.m_audioResampleQuality))
               {
                 CLog::Log(LOGERROR, "PAPlayer: Error initializing resampler!");
                 return false;
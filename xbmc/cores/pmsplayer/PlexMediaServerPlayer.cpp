@@ -44,6 +44,7 @@
 
 #include <vector>
 #include <set>
+#include <libkern/OSAtomic.h>
 
 bool CPlexMediaServerPlayer::g_needToRestartMediaServer = false;
 
@@ -55,6 +56,9 @@ CPlexMediaServerPlayer::CPlexMediaServerPlayer(IPlayerCallback& callback)
     , m_frameMutex(ipc::open_or_create, "plex_frame_mutex")
     , m_frameCond(ipc::open_or_create, "plex_frame_cond")
     , m_frameCount(0)
+    , m_frameRing(0)
+    , m_frameRingReader(0)
+    , m_frameRingCount(0)
 { 
   m_paused = false;
   m_playing = false;
@@ -71,12 +75,7 @@ CPlexMediaServerPlayer::CPlexMediaServerPlayer(IPlayerCallback& callback)
 CPlexMediaServerPlayer::~CPlexMediaServerPlayer()
 {
   CloseFile();
-  
-  if (m_mappedRegion)
-  {
-    delete m_mappedRegion;
-    m_mappedRegion = 0;
-  }
+  UnmapFrames();
   
   if (m_pDlgCache)
   {
@@ -236,9 +235,13 @@ void CPlexMediaServerPlayer::Process()
       Sleep(100);
     }
 
+    // With a frame ring there's nothing to wait for, so just look for new frames often.
+    if (m_frameRing)
+      Render();
+    
     // See if we have data from the Media Server.
     string line;
-    if (m_http.ReadLine(line, 100))
+    if (m_http.ReadLine(line, m_frameRing ? 5 : 100))
     {
       if (line == "PLAYING")
         OnResumed();
@@ -413,8 +416,22 @@ void CPlexMediaServerPlayer::Render()
   if (!m_playing)
     return;
   
-  // Grab the new frame out of shared memory.
+  if (m_frameRing)
   {
+    // Render straight out of the slot, it's ours until the next frame.
+    const char* frame;
+    if (ClaimLatestFrame(frame) == false)
+      return;
+    
+    g_renderManager.SetRGB32ImageRef(frame, m_height, m_width, m_width*4);
+    
+    // Now that the renderer has let go of the previous slot, the server can have it back.
+    m_frameRing->reading[m_frameRingReader] = PLEX_FRAME_RING_NONE;
+    m_frameRingReader ^= 1;
+  }
+  else
+  {
+    // Grab the new frame out of shared memory.
     //printf("Frame %08d @ %f\n", ++m_frameCount, getTime());
 
     ipc::scoped_lock<ipc::named_mutex> lock(m_frameMutex);
@@ -424,6 +441,56 @@ void CPlexMediaServerPlayer::Render()
   g_application.NewFrame();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+bool CPlexMediaServerPlayer::ClaimLatestFrame(const char*& frame)
+{
+  int next = m_frameRingReader ^ 1;
+  
+  // If the server gets in while we're claiming a slot, just try the next one it publishes.
+  for (uint32_t tries = 0; tries < m_frameRing->numSlots; tries++)
+  {
+    uint32_t count = m_frameRing->frameCount;
+    if (count == m_frameRingCount)
+      return false;
+    
+    OSMemoryBarrier();
+    uint32_t slot = m_frameRing->latest;
+    if (slot >= m_frameRing->numSlots)
+      return false;
+    
+    m_frameRing->reading[next] = slot;
+    OSMemoryBarrier();
+    
+    if ((m_frameRing->sequence[slot] & 1) == 0)
+    {
+      m_frameRingCount = count;
+      frame = (const char*)m_frameRing + m_frameRing->headerSize + slot * m_frameRing->slotSize;
+      return true;
+    }
+    
+    m_frameRing->reading[next] = PLEX_FRAME_RING_NONE;
+  }
+  
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPlexMediaServerPlayer::UnmapFrames()
+{
+  if (m_frameRing)
+  {
+    // Make the renderer take a copy of what's on screen before it goes away.
+    g_renderManager.SetRGB32ImageRef(0, m_height, m_width, m_width*4);
+    m_frameRing = 0;
+  }
+  
+  if (m_mappedRegion)
+  {
+    delete m_mappedRegion;
+    m_mappedRegion = 0;
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void CPlexMediaServerPlayer::OnPlaybackEnded(const string& args)
 {
@@ -459,9 +526,18 @@ void CPlexMediaServerPlayer::OnPlaybackStarted()
   {
     g_renderManager.Configure(m_width, m_height, m_width, m_height, 30.0f, CONF_FLAGS_FULLSCREEN | CONF_FLAGS_RGB);
     
-    ipc::scoped_lock<ipc::named_mutex> lock(m_frameMutex);
-    memset(m_mappedRegion->get_address(), 0, m_height*m_width*4);
-    g_renderManager.SetRGB32Image((const char*)m_mappedRegion->get_address(), m_height, m_width, m_width*4);
+    if (m_frameRing)
+    {
+      // Start off black, the ring itself belongs to the server.
+      vector<char> black(m_height*m_width*4, 0);
+      g_renderManager.SetRGB32Image(&black[0], m_height, m_width, m_width*4);
+    }
+    else
+    {
+      ipc::scoped_lock<ipc::named_mutex> lock(m_frameMutex);
+      memset(m_mappedRegion->get_address(), 0, m_height*m_width*4);
+      g_renderManager.SetRGB32Image((const char*)m_mappedRegion->get_address(), m_height, m_width, m_width*4);
+    }
   }
   catch(...)
   {
@@ -492,16 +568,30 @@ void CPlexMediaServerPlayer::OnFrameMap(const string& args)
     ipc::file_mapping fileMapping(file.c_str(), ipc::read_write);
 
     // Whack the region if it already exists.
-    if (m_mappedRegion)
-    {
-      delete m_mappedRegion;
-      m_mappedRegion = 0;
-    }
+    UnmapFrames();
     
     // Map the whole file in this process.
     m_mappedRegion = new ipc::mapped_region(fileMapping, ipc::read_write);
     printf("Mapped region is %ld bytes.\n", m_mappedRegion->get_size());
     
+    // See if the server is giving us a frame ring.
+    PlexFrameRingHeader* ring = (PlexFrameRingHeader*)m_mappedRegion->get_address();
+    size_t frameSize = m_width*m_height*4;
+    if (m_mappedRegion->get_size() >= sizeof(PlexFrameRingHeader) &&
+        ring->magic == PLEX_FRAME_RING_MAGIC &&
+        ring->numSlots >= PLEX_FRAME_RING_MIN_SLOTS && ring->numSlots <= PLEX_FRAME_RING_MAX_SLOTS &&
+        ring->slotSize >= frameSize && ring->headerSize >= sizeof(PlexFrameRingHeader) &&
+        ring->headerSize + (size_t)ring->numSlots * ring->slotSize <= m_mappedRegion->get_size())
+    {
+      printf("Using a frame ring of %d slots.\n", ring->numSlots);
+      
+      m_frameRing = ring;
+      m_frameRing->reading[0] = PLEX_FRAME_RING_NONE;
+      m_frameRing->reading[1] = PLEX_FRAME_RING_NONE;
+      m_frameRingReader = 0;
+      m_frameRingCount = m_frameRing->frameCount;
+    }
+    
     // Note that playback has started.
     OnPlaybackStarted();
    }
@@ -21,6 +21,7 @@
  *
  */
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,34 @@
 
 using namespace std;
 namespace ipc = boost::interprocess;
+
+#define PLEX_FRAME_RING_MAGIC     0x52465850 // "PXFR"
+#define PLEX_FRAME_RING_MIN_SLOTS 4
+#define PLEX_FRAME_RING_MAX_SLOTS 16
+#define PLEX_FRAME_RING_NONE      0xffffffff
+
+/// Header at the start of the frame map when the server hands frames over through a ring of
+/// slots rather than a single buffer guarded by plex_frame_mutex. Frames are BGRA, width*height*4.
+///
+/// The server writes each frame into a slot which is neither "latest" nor one of the "reading"
+/// ones, making the slot's sequence number odd while it writes and even again once it's done,
+/// then publishes it by setting "latest" and bumping "frameCount". After making a sequence number
+/// odd it checks "reading" again, and picks another slot if we've just claimed that one.
+///
+/// We claim a slot by storing it in one of the "reading" entries before checking its sequence
+/// number, so between the two checks one side always sees the other, and neither ever waits.
+/// Two entries let us keep the slot on screen until the renderer has switched to the new one.
+struct PlexFrameRingHeader
+{
+  uint32_t          magic;
+  uint32_t          numSlots;
+  uint32_t          slotSize;
+  uint32_t          headerSize;   // Offset of the first slot.
+  volatile uint32_t frameCount;   // Frames published so far.
+  volatile uint32_t latest;       // Slot holding the most recent frame.
+  volatile uint32_t reading[2];   // Slots we're using, or PLEX_FRAME_RING_NONE.
+  volatile uint32_t sequence[PLEX_FRAME_RING_MAX_SLOTS];
+};
  
 class CPlexMediaServerPlayer : public IPlayer, public CThread
 {
@@ -110,6 +139,9 @@ private:
   void OnResumed();
   void OnProgress(int nPct); 
   
+  void UnmapFrames();
+  bool ClaimLatestFrame(const char*& frame);
+  
   virtual void Process();
   
   double getTime();
@@ -136,4 +168,8 @@ private:
   ipc::named_mutex     m_frameMutex;
   ipc::named_condition m_frameCond;
   ipc::mapped_region*  m_mappedRegion;
+  
+  PlexFrameRingHeader* m_frameRing;          // Null if the server uses a single frame buffer.
+  int                  m_frameRingReader;    // Which of the reading entries holds the frame on screen.
+  uint32_t             m_frameRingCount;     // Frame count when we last claimed a frame.
 };
@@ -31,6 +31,10 @@
 
 #include "log.h"
 
+#ifdef _WIN32PC
+#include <intrin.h>
+#endif
+
 using namespace std;
 
 // In seconds
@@ -154,6 +158,8 @@ CCPUInfo::CCPUInfo(void)
 
   readProcStat(m_userTicks, m_niceTicks, m_systemTicks, m_idleTicks);
 #endif
+
+  ReadCPUFeatures();
 }
 
 CCPUInfo::~CCPUInfo()
@@ -297,6 +303,30 @@ CStdString CCPUInfo::GetCoresUsageString() const
   return strCores;
 }
 
+void CCPUInfo::ReadCPUFeatures()
+{
+  m_cpuFeatures = 0;
+
+  unsigned int regs[4] = { 0, 0, 0, 0 }; // eax, ebx, ecx, edx of cpuid function 1
+#if defined(_WIN32PC)
+  __cpuid((int*)regs, 1);
+#elif defined(__i386__) && defined(__PIC__)
+  // ebx holds the GOT pointer here and can't be clobbered
+  __asm__ __volatile__("xchgl %%ebx, %1\n\tcpuid\n\txchgl %%ebx, %1"
+                       : "=a"(regs[0]), "=r"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(1), "c"(0));
+#elif defined(__i386__) || defined(__x86_64__)
+  __asm__ __volatile__("cpuid"
+                       : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(1), "c"(0));
+#endif
+
+  if (regs[3] & (1 << 23)) m_cpuFeatures |= CPU_FEATURE_MMX;
+  if (regs[3] & (1 << 25)) m_cpuFeatures |= CPU_FEATURE_MMX2 | CPU_FEATURE_SSE;
+  if (regs[3] & (1 << 26)) m_cpuFeatures |= CPU_FEATURE_SSE2;
+  if (regs[2] & (1 << 0))  m_cpuFeatures |= CPU_FEATURE_SSE3;
+  if (regs[2] & (1 << 9))  m_cpuFeatures |= CPU_FEATURE_SSSE3;
+  if (regs[2] & (1 << 19)) m_cpuFeatures |= CPU_FEATURE_SSE4;
+}
+
 CCPUInfo g_cpuInfo;
 
 /*
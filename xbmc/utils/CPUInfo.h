@@ -29,6 +29,14 @@
 #include <string>
 #include <map>
 
+#define CPU_FEATURE_MMX      (1 << 0)
+#define CPU_FEATURE_MMX2     (1 << 1)
+#define CPU_FEATURE_SSE      (1 << 2)
+#define CPU_FEATURE_SSE2     (1 << 3)
+#define CPU_FEATURE_SSE3     (1 << 4)
+#define CPU_FEATURE_SSSE3    (1 << 5)
+#define CPU_FEATURE_SSE4     (1 << 6)
+
 struct CoreInfo
 {
   int    m_id;
@@ -58,6 +66,7 @@ public:
   float getCPUFrequency() { return m_cpuFreq; }
   CTemperature getTemperature();
   std::string& getCPUModel() { return m_cpuModel; }
+  unsigned int GetCPUFeatures() { return m_cpuFeatures; }
 
   const CoreInfo &GetCoreInfo(int nCoreId);
   bool HasCoreId(int nCoreId) const;
@@ -67,6 +76,7 @@ public:
 private:
   bool readProcStat(unsigned long long& user, unsigned long long& nice, unsigned long long& system,
     unsigned long long& idle);
+  void ReadCPUFeatures();
 
   FILE* m_fProcStat;
   FILE* m_fProcTemperature;
@@ -81,6 +91,7 @@ private:
   float m_cpuFreq;
   std::string m_cpuModel;
   int m_cpuCount;
+  unsigned int m_cpuFeatures;
 
   std::map<int, CoreInfo> m_cores;
 };
@@ -93,7 +93,8 @@ void CGUIInfoManager::CCombinedValue::operator =(const CGUIInfoManager::CCombine
 {
   this->m_info = mSrc.m_info;
   this->m_id = mSrc.m_id;
-  this->m_postfix = mSrc.m_postfix;
+  this->m_code = mSrc.m_code;
+  this->m_dependencies = mSrc.m_dependencies;
 }
 
 CGUIInfoManager::CGUIInfoManager()
@@ -3474,46 +3475,97 @@ int CGUIInfoManager::GetOperator(const char ch)
 
 bool CGUIInfoManager::EvaluateBooleanExpression(const CCombinedValue &expression, bool &result, DWORD dwContextWindow, const CGUIListItem *item)
 {
-  // stack to save our bool state as we go
-  stack<bool> save;
+  if (expression.m_code.empty())
+    return false;
+
+  bool value = false;
+  for (unsigned int i = 0; i < expression.m_code.size(); i++)
+  {
+    const CInstruction &instruction = expression.m_code[i];
+    switch (instruction.op)
+    {
+    case OP_GET_BOOL:
+      value = GetBool(instruction.arg, dwContextWindow, item);
+      break;
+    case OP_NOT:
+      value = !value;
+      break;
+    case OP_JUMP_IF_FALSE:
+      if (!value) i += instruction.arg;
+      break;
+    case OP_JUMP_IF_TRUE:
+      if (value) i += instruction.arg;
+      break;
+    }
+  }
+  result = value;
+  return true;
+}
 
-  for (list<int>::const_iterator it = expression.m_postfix.begin(); it != expression.m_postfix.end(); ++it)
+// Turns the postfix expression into code for EvaluateBooleanExpression().  Each operand
+// becomes a self contained block of code that leaves its value in the result register,
+// so blocks can be joined without fixing up the (relative) jumps inside them.
+bool CGUIInfoManager::CompileBooleanExpression(const list<int> &postfix, CCombinedValue &expression) const
+{
+  stack< vector<CInstruction> > save;
+  expression.m_dependencies = CONDITION_CONSTANT;
+
+  for (list<int>::const_iterator it = postfix.begin(); it != postfix.end(); ++it)
   {
     int expr = *it;
     if (expr == -OPERATOR_NOT)
-    { // NOT the top item on the stack
+    {
       if (save.size() < 1) return false;
-      bool expr = save.top();
-      save.pop();
-      save.push(!expr);
+      CInstruction instruction = { OP_NOT, 0 };
+      save.top().push_back(instruction);
     }
-    else if (expr == -OPERATOR_AND)
-    { // AND the top two items on the stack
+    else if (expr == -OPERATOR_AND || expr == -OPERATOR_OR)
+    { // left, then skip right if left already decides it
       if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left && right);
+      vector<CInstruction> right = save.top(); save.pop();
+      vector<CInstruction> &left = save.top();
+      CInstruction instruction = { expr == -OPERATOR_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE, (int)right.size() };
+      left.push_back(instruction);
+      left.insert(left.end(), right.begin(), right.end());
     }
-    else if (expr == -OPERATOR_OR)
-    { // OR the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left || right);
+    else
+    {
+      CInstruction instruction = { OP_GET_BOOL, expr };
+      save.push(vector<CInstruction>(1, instruction));
+      expression.m_dependencies = max(expression.m_dependencies, GetConditionDependencies(expr));
     }
-    else  // operator
-      save.push(GetBool(expr, dwContextWindow, item));
   }
   if (save.size() != 1) return false;
-  result = save.top();
+  expression.m_code = save.top();
   return true;
 }
 
+int CGUIInfoManager::GetConditionDependencies(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= COMBINED_VALUES_START && (condition - COMBINED_VALUES_START) < (int)(m_CombinedValues.size()))
+    return m_CombinedValues[condition - COMBINED_VALUES_START].m_dependencies;
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE ||
+      condition == SYSTEM_PLATFORM_LINUX || condition == SYSTEM_PLATFORM_WINDOWS || condition == SYSTEM_PLATFORM_XBOX)
+    return CONDITION_CONSTANT;
+  // the skin is reloaded when the theme changes, which clears all of these
+  if (condition >= SKIN_HAS_THEME_START && condition <= SKIN_HAS_THEME_END)
+    return CONDITION_DEPENDS_SKIN;
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    int info = abs(m_multiInfo[condition - MULTI_INFO_START].m_info);
+    if (info == SKIN_BOOL || info == SKIN_STRING)
+      return CONDITION_DEPENDS_SKIN;
+  }
+  return CONDITION_DEPENDS_ANYTHING;
+}
+
 int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
 {
   CCombinedValue comb;
   comb.m_info = expression;
   comb.m_id = COMBINED_VALUES_START + m_CombinedValues.size();
+  list<int> postfix;
 
   // operator stack
   stack<char> save;
@@ -3529,7 +3581,7 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
       {
         int iOp = TranslateSingleString(operand);
         if (iOp)
-          comb.m_postfix.push_back(iOp);
+          postfix.push_back(iOp);
         operand.clear();
       }
       // handle closing parenthesis
@@ -3543,7 +3595,7 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
           if (oper == '[')
             break;
 
-          comb.m_postfix.push_back(-GetOperator(oper));
+          postfix.push_back(-GetOperator(oper));
         }
       }
       else
@@ -3556,7 +3608,7 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
           if (save.top() == '[' && expression[i] != ']')
             break;
 
-          comb.m_postfix.push_back(-GetOperator(save.top()));  // negative denotes operator
+          postfix.push_back(-GetOperator(save.top()));  // negative denotes operator
           save.pop();
         }
         save.push(expression[i]);
@@ -3569,18 +3621,16 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
   }
 
   if (!operand.empty())
-    comb.m_postfix.push_back(TranslateSingleString(operand));
+    postfix.push_back(TranslateSingleString(operand));
 
   // finish up by adding any operators
   while (!save.empty())
   {
-    comb.m_postfix.push_back(-GetOperator(save.top()));
+    postfix.push_back(-GetOperator(save.top()));
     save.pop();
   }
 
-  // test evaluate
-  bool test;
-  if (!EvaluateBooleanExpression(comb, test, WINDOW_INVALID))
+  if (!CompileBooleanExpression(postfix, comb))
     CLog::Log(LOGERROR, "Error evaluating boolean expression %s", expression.c_str());
   // success - add to our combined values
   m_CombinedValues.push_back(comb);
@@ -3590,6 +3640,7 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
 void CGUIInfoManager::Clear()
 {
   m_CombinedValues.clear();
+  ResetSkinCache();  // ids of the combined values are reused
 }
 
 #define FRAME_CLUMP_SIZE 3
@@ -4075,6 +4126,12 @@ void CGUIInfoManager::ResetPersistentCache()
   m_persistentBoolCache.clear();
 }
 
+void CGUIInfoManager::ResetSkinCache()
+{
+  CSingleLock lock(m_critInfo);
+  m_skinBoolCache.clear();
+}
+
 inline void CGUIInfoManager::CacheBool(int condition, DWORD contextWindow, bool result, bool persistent)
 {
   // windows have id's up to 13100 or thereabouts (ie 2^14 needed)
@@ -4083,8 +4140,10 @@ inline void CGUIInfoManager::CacheBool(int condition, DWORD contextWindow, bool
   int hash = ((contextWindow & 0x3fff) << 18) | (condition & 0x3ffff);
   if (persistent)
     m_persistentBoolCache.insert(pair<int, bool>(hash, result));
-  else
+  else if (GetConditionDependencies(condition) == CONDITION_DEPENDS_ANYTHING)
     m_boolCache.insert(pair<int, bool>(hash, result));
+  else // stays valid until the skin settings change
+    m_skinBoolCache.insert(pair<int, bool>(hash, result));
 }
 
 bool CGUIInfoManager::IsCached(int condition, DWORD contextWindow, bool &result) const
@@ -4100,6 +4159,12 @@ bool CGUIInfoManager::IsCached(int condition, DWORD contextWindow, bool &result)
     result = (*it).second;
     return true;
   }
+  it = m_skinBoolCache.find(hash);
+  if (it != m_skinBoolCache.end())
+  {
+    result = (*it).second;
+    return true;
+  }
   it = m_persistentBoolCache.find(hash);
   if (it != m_persistentBoolCache.end())
   {
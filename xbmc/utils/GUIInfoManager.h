@@ -608,6 +608,7 @@ public:
 
   void ResetCache();
   void ResetPersistentCache();
+  void ResetSkinCache();   ///< Call when a skin setting changes
 
   CStdString GetItemLabel(const CFileItem *item, int info) const;
   CStdString GetItemImage(const CFileItem *item, int info) const;
@@ -689,18 +690,33 @@ protected:
   int m_nextWindowID;
   int m_prevWindowID;
 
+  // what a condition's value depends on, which decides how long its result may be cached
+  enum { CONDITION_CONSTANT = 0, CONDITION_DEPENDS_SKIN, CONDITION_DEPENDS_ANYTHING };
+
+  // boolean expressions are compiled into a flat list of these, evaluated with a single
+  // result register.  The jumps skip the right hand side of AND/OR when the left decides it.
+  enum { OP_GET_BOOL = 0, OP_NOT, OP_JUMP_IF_FALSE, OP_JUMP_IF_TRUE };
+  struct CInstruction
+  {
+    int op;
+    int arg;              // condition to get, or number of instructions to jump over
+  };
+
   class CCombinedValue
   {
   public:
     CStdString m_info;    // the text expression
     int m_id;             // the id used to identify this expression
-    std::list<int> m_postfix;  // the postfix binary expression
+    std::vector<CInstruction> m_code;  // the compiled expression, empty if it didn't make sense
+    int m_dependencies;   // the most volatile thing any of its conditions depend on
     void operator=(const CCombinedValue& mSrc);
   };
 
   int GetOperator(const char ch);
   int TranslateBooleanExpression(const CStdString &expression);
+  bool CompileBooleanExpression(const std::list<int> &postfix, CCombinedValue &expression) const;
   bool EvaluateBooleanExpression(const CCombinedValue &expression, bool &result, DWORD dwContextWindow, const CGUIListItem *item=NULL);
+  int GetConditionDependencies(int condition) const;
 
   std::vector<CCombinedValue> m_CombinedValues;
 
@@ -709,6 +725,9 @@ protected:
   void CacheBool(int condition, DWORD contextWindow, bool result, bool persistent=false);
   std::map<int, bool> m_boolCache;
 
+  // results which only change with the skin settings
+  std::map<int, bool> m_skinBoolCache;
+
   // persistent cache
   std::map<int, bool> m_persistentBoolCache;
 
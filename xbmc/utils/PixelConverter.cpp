@@ -0,0 +1,249 @@
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "PixelConverter.h"
+#include "CPUInfo.h"
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// yuv to rgb coefficients, scaled by 64. they're small enough for the whole
+// conversion to fit in 16 bits, where it only saturates if the result would clamp anyway.
+struct YUVCoefs
+{
+  int y, rv, gu, gv, bu;
+};
+
+static const YUVCoefs coefs_bt601 = { 75, 102, 25, 52, 129 };
+static const YUVCoefs coefs_bt709 = { 75, 115, 14, 34, 135 };
+
+static inline BYTE Clamp(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static void YV12ToRGB32Row_C(const BYTE* y, const BYTE* u, const BYTE* v, BYTE* dst, int x, int width, const YUVCoefs& k)
+{
+  for (; x < width; x++)
+  {
+    int c  = (y[x] - 16) * k.y + 32;
+    int cu = u[x >> 1] - 128;
+    int cv = v[x >> 1] - 128;
+
+    dst[x*4 + 0] = Clamp((c + k.bu * cu) >> 6);
+    dst[x*4 + 1] = Clamp((c - k.gu * cu - k.gv * cv) >> 6);
+    dst[x*4 + 2] = Clamp((c + k.rv * cv) >> 6);
+    dst[x*4 + 3] = 0xff;
+  }
+}
+
+static void BlendRow_C(const BYTE* a, const BYTE* b, int f, BYTE* dst, int x, int bytes)
+{
+  for (; x < bytes; x++)
+    dst[x] = a[x] + (((b[x] - a[x]) * f) >> 7);
+}
+
+#ifdef __SSE2__
+// 16 pixels at a time, returns how many were done
+static int YV12ToRGB32Row_SSE2(const BYTE* y, const BYTE* u, const BYTE* v, BYTE* dst, int width, const YUVCoefs& k)
+{
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8((char)0xff);
+  const __m128i c16   = _mm_set1_epi16(16);
+  const __m128i c128  = _mm_set1_epi16(128);
+  const __m128i round = _mm_set1_epi16(32);
+  const __m128i ky    = _mm_set1_epi16(k.y);
+  const __m128i krv   = _mm_set1_epi16(k.rv);
+  const __m128i kgu   = _mm_set1_epi16(k.gu);
+  const __m128i kgv   = _mm_set1_epi16(k.gv);
+  const __m128i kbu   = _mm_set1_epi16(k.bu);
+
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i yy = _mm_loadu_si128((const __m128i*)(y + x));
+    __m128i uu = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + (x >> 1))), zero), c128);
+    __m128i vv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v + (x >> 1))), zero), c128);
+
+    // luma for pixels 0-7 and 8-15
+    __m128i cl = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(yy, zero), c16), ky), round);
+    __m128i ch = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(yy, zero), c16), ky), round);
+
+    // chroma terms for 8 samples, each shared by two pixels
+    __m128i r  = _mm_mullo_epi16(vv, krv);
+    __m128i g  = _mm_add_epi16(_mm_mullo_epi16(uu, kgu), _mm_mullo_epi16(vv, kgv));
+    __m128i b  = _mm_mullo_epi16(uu, kbu);
+
+    __m128i rl = _mm_srai_epi16(_mm_adds_epi16(cl, _mm_unpacklo_epi16(r, r)), 6);
+    __m128i rh = _mm_srai_epi16(_mm_adds_epi16(ch, _mm_unpackhi_epi16(r, r)), 6);
+    __m128i gl = _mm_srai_epi16(_mm_subs_epi16(cl, _mm_unpacklo_epi16(g, g)), 6);
+    __m128i gh = _mm_srai_epi16(_mm_subs_epi16(ch, _mm_unpackhi_epi16(g, g)), 6);
+    __m128i bl = _mm_srai_epi16(_mm_adds_epi16(cl, _mm_unpacklo_epi16(b, b)), 6);
+    __m128i bh = _mm_srai_epi16(_mm_adds_epi16(ch, _mm_unpackhi_epi16(b, b)), 6);
+
+    __m128i rr = _mm_packus_epi16(rl, rh);
+    __m128i gg = _mm_packus_epi16(gl, gh);
+    __m128i bb = _mm_packus_epi16(bl, bh);
+
+    // interleave to BGRA
+    __m128i bgl = _mm_unpacklo_epi8(bb, gg);
+    __m128i bgh = _mm_unpackhi_epi8(bb, gg);
+    __m128i ral = _mm_unpacklo_epi8(rr, alpha);
+    __m128i rah = _mm_unpackhi_epi8(rr, alpha);
+
+    __m128i* out = (__m128i*)(dst + x*4);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(bgl, ral));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bgl, ral));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bgh, rah));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bgh, rah));
+  }
+  return x;
+}
+
+// 16 bytes at a time, returns how many were done
+static int BlendRow_SSE2(const BYTE* a, const BYTE* b, int f, BYTE* dst, int bytes)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i kf   = _mm_set1_epi16(f);
+
+  int x = 0;
+  for (; x + 16 <= bytes; x += 16)
+  {
+    __m128i aa = _mm_loadu_si128((const __m128i*)(a + x));
+    __m128i bb = _mm_loadu_si128((const __m128i*)(b + x));
+
+    __m128i al = _mm_unpacklo_epi8(aa, zero);
+    __m128i ah = _mm_unpackhi_epi8(aa, zero);
+    __m128i dl = _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(bb, zero), al), kf), 7);
+    __m128i dh = _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(bb, zero), ah), kf), 7);
+
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(_mm_add_epi16(al, dl), _mm_add_epi16(ah, dh)));
+  }
+  return x;
+}
+#endif
+
+bool CPixelConverter::UseSSE2()
+{
+#ifdef __SSE2__
+  return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+void CPixelConverter::YV12ToRGB32(BYTE* const src[3], const int srcStride[3], int width, int height,
+                                  BYTE* dst, int dstStride, bool bt709)
+{
+  const YUVCoefs& k = bt709 ? coefs_bt709 : coefs_bt601;
+#ifdef __SSE2__
+  bool sse2 = UseSSE2();
+#endif
+
+  for (int line = 0; line < height; line++)
+  {
+    const BYTE* y = src[0] + line * srcStride[0];
+    const BYTE* u = src[1] + (line >> 1) * srcStride[1];
+    const BYTE* v = src[2] + (line >> 1) * srcStride[2];
+    BYTE* out = dst + line * dstStride;
+
+    int x = 0;
+#ifdef __SSE2__
+    if (sse2)
+      x = YV12ToRGB32Row_SSE2(y, u, v, out, width, k);
+#endif
+    YV12ToRGB32Row_C(y, u, v, out, x, width, k);
+  }
+}
+
+void CPixelConverter::ScaleRGB32(const BYTE* src, int srcWidth, int srcHeight, int srcStride,
+                                 BYTE* dst, int dstWidth, int dstHeight, int dstStride)
+{
+  if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0)
+    return;
+
+#ifdef __SSE2__
+  bool sse2 = UseSSE2();
+#endif
+
+  // source position of the centre of each destination pixel in 16.16, the fraction
+  // is kept to 7 bits so the blends fit in 16 bits.
+  vector<int> xpos(dstWidth), xfrac(dstWidth);
+  for (int x = 0; x < dstWidth; x++)
+  {
+    __int64 pos = ((__int64)(2 * x + 1) * srcWidth << 16) / (2 * dstWidth) - 0x8000;
+    if (pos < 0) pos = 0;
+    xpos[x]  = (int)(pos >> 16);
+    xfrac[x] = (int)(pos >> 9) & 0x7f;
+    if (xpos[x] >= srcWidth - 1)
+    {
+      xpos[x]  = srcWidth - 1;
+      xfrac[x] = 0;
+    }
+  }
+
+  // each output line is blended vertically into a whole source line first, then horizontally
+  vector<BYTE> line(srcWidth * 4);
+  for (int y = 0; y < dstHeight; y++)
+  {
+    __int64 pos = ((__int64)(2 * y + 1) * srcHeight << 16) / (2 * dstHeight) - 0x8000;
+    if (pos < 0) pos = 0;
+    int sy = (int)(pos >> 16);
+    int fy = (int)(pos >> 9) & 0x7f;
+    if (sy >= srcHeight - 1)
+    {
+      sy = srcHeight - 1;
+      fy = 0;
+    }
+
+    const BYTE* row0 = src + sy * srcStride;
+    const BYTE* row1 = fy ? row0 + srcStride : row0;
+    if (fy == 0)
+      memcpy(&line[0], row0, srcWidth * 4);
+    else
+    {
+      int x = 0;
+#ifdef __SSE2__
+      if (sse2)
+        x = BlendRow_SSE2(row0, row1, fy, &line[0], srcWidth * 4);
+#endif
+      BlendRow_C(row0, row1, fy, &line[0], x, srcWidth * 4);
+    }
+
+    BYTE* out = dst + y * dstStride;
+    for (int x = 0; x < dstWidth; x++)
+    {
+      const BYTE* a = &line[xpos[x] * 4];
+      const BYTE* b = xfrac[x] ? a + 4 : a;
+      int f = xfrac[x];
+
+      out[x*4 + 0] = a[0] + (((b[0] - a[0]) * f) >> 7);
+      out[x*4 + 1] = a[1] + (((b[1] - a[1]) * f) >> 7);
+      out[x*4 + 2] = a[2] + (((b[2] - a[2]) * f) >> 7);
+      out[x*4 + 3] = a[3] + (((b[3] - a[3]) * f) >> 7);
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef PIXELCONVERTER_H
+#define PIXELCONVERTER_H
+
+/*
+ *      Copyright (C) 2005-2008 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Colour conversion and scaling of pictures on the CPU, for where there's no GPU to do it
+// (software rendering, thumbnails). The results are the same whichever implementation runs.
+// The SSE2 one is only built when the compiler targets SSE2 (__SSE2__, always so on x86_64),
+// and is then used if the CPU has it. Other builds only have the plain C one.
+class CPixelConverter
+{
+public:
+  // YV12 to 32 bit BGRA (PIX_FMT_RGB32 on little endian, GL_BGRA), with BT.601 or BT.709 coefficients
+  static void YV12ToRGB32(BYTE* const src[3], const int srcStride[3], int width, int height,
+                          BYTE* dst, int dstStride, bool bt709 = false);
+
+  // bilinear resize of a 32 bit picture
+  static void ScaleRGB32(const BYTE* src, int srcWidth, int srcHeight, int srcStride,
+                         BYTE* dst, int dstWidth, int dstHeight, int dstStride);
+
+private:
+  static bool UseSSE2();
+};
+
+#endif